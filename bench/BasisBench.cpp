@@ -0,0 +1,62 @@
+#include <NumericalUtils.hpp>
+
+#include "BenchUtils.hpp"
+
+using namespace nya;
+
+// evaluation of an approximate solution (linear combination of trial functions) on many points,
+// as done when plotting or post-processing results of galerkin
+template <typename Basis, typename Functions>
+void benchEvaluation(const char* name, const Basis& basis, const Functions& functions, const Range<double>& points) {
+    std::vector<double> coefs (basis.size());
+    for (size_t i = 0; i < coefs.size(); ++i) {
+        coefs[i] = 1.0 / (i + 1);
+    }
+    std::vector<double> out (points.count());
+
+    const auto viaFunctions = makeTrialFunction<double>(functions, coefs);
+    const double functionsMs = measureMs([&] {
+        std::transform(points.begin(), points.end(), out.begin(), viaFunctions);
+        doNotOptimize(out);
+    });
+    const auto series = makeTrialFunction(basis, coefs);
+    const double scalarMs = measureMs([&] {
+        std::transform(points.begin(), points.end(), out.begin(), series);
+        doNotOptimize(out);
+    });
+    const double batchMs = measureMs([&] {
+        tabulate<nativeBatchSize<double>>(series, points.begin(), points.end(), out.begin());
+        doNotOptimize(out);
+    });
+    std::printf("%-10s %6zu %16.3f %16.3f %16.3f\n", name, basis.maxOrder(), functionsMs, scalarMs, batchMs);
+}
+
+// Galerkin assembly on tabulated nodes: the hot loop evaluates all trials and L(trials) at every node
+template <template <typename> typename DiffMethod = LFD1, typename Trials>
+double benchAssembly(const Trials& trials, const QuadratureRule<double>& rule) {
+    const auto L = [](auto f) { return sum(D<DiffMethod>(f), negate(f)); };
+    return measureMs([&] { doNotOptimize(detail::assembleGalerkinTabulated(L, trials, rule)); }, 3);
+}
+
+int main() {
+    const auto points = Range<double> { -1.0, 1'000'000, 2e-6 };
+    std::printf("evaluation of sum(c_i * phi_i) on %zu points\n", points.count());
+    std::printf("%-10s %6s %16s %16s %16s\n", "basis", "order", "functions, ms", "series, ms", "series batch, ms");
+    for (size_t order : { 5u, 10u, 25u }) {
+        benchEvaluation("monomial", PolynomialBasis<double>(order), polynomials(order), points);
+        benchEvaluation("chebyshev", ChebyshevBasis<double>(order), chebyshevPolynomials(order), points);
+    }
+
+    const auto rule = QuadratureRule<double>::fromRange<Euler>(Range<double> { 0.0, 1'000'000, 1e-6 });
+    const auto compileTime = makeBasis(
+        [](auto) { return 1.0; }, [](auto x) { return x; }, [](auto x) { return x * x; },
+        [](auto x) { return x * x * x; }, [](auto x) { return x * x * x * x; },
+        [](auto x) { return x * x * x * x * x; });
+    std::printf("\nGalerkin assembly, 6 monomials, L(y) = y' - y, %zu nodes\n", rule.size());
+    std::printf("%-28s %10.3f ms\n", "vector of std::function", benchAssembly(polynomials(5), rule));
+    std::printf("%-28s %10.3f ms\n", "PolynomialBasis", benchAssembly(PolynomialBasis<double>(5), rule));
+    std::printf("%-28s %10.3f ms\n", "makeBasis (compile time)", benchAssembly(compileTime, rule));
+    std::printf("%-28s %10.3f ms\n", "PolynomialBasis, AutoDiff",
+                benchAssembly<AutoDiff>(PolynomialBasis<double>(5), rule));
+    std::printf("%-28s %10.3f ms\n", "makeBasis, AutoDiff", benchAssembly<AutoDiff>(compileTime, rule));
+}
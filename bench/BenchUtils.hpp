@@ -0,0 +1,31 @@
+#ifndef NUMUTILS_BENCHUTILS_HPP
+#define NUMUTILS_BENCHUTILS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+/**
+ * Runs f `repeats` times and returns the best wall time in milliseconds.
+ */
+template <typename F>
+double measureMs(F f, int repeats = 5) {
+    double best = 1e300;
+    for (int i = 0; i < repeats; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(stop - start).count());
+    }
+    return best;
+}
+
+/**
+ * Keeps the compiler from optimizing away computation of value.
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+#endif //NUMUTILS_BENCHUTILS_HPP
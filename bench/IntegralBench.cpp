@@ -0,0 +1,131 @@
+#include <NumericalUtils.hpp>
+
+#include "BenchUtils.hpp"
+
+using namespace nya;
+
+// integrand from examples/Minimal.cpp, written with unqualified exp so it also accepts batches
+const auto expXByY = [](auto x, auto y) { using std::exp; return exp(x)*y; };
+
+// analytic values of the integral over [0, 1] with the other variable set to 1
+const double exact[] = { std::exp(1) - 1.0, std::exp(1) * 0.5 };
+
+template <template <typename> typename Stepper, size_t var, size_t p = 7, typename F>
+void benchIntegral(const char* name, F f) {
+    const auto range = discreteRange<p>(0.0, 1.0);
+    const auto integralByVar = integral<Stepper, var>(f);
+    double value = 0;
+    const double ms = measureMs([&] { value = integralByVar(range, 1.0, 1.0); doNotOptimize(value); });
+    std::printf("%-24s %10.3f ms   error %.3e\n", name, ms, std::abs(value - exact[var]));
+}
+
+template <size_t var>
+void benchAll() {
+    std::printf("integral of exp(x)*y by %s on [0, 1], 10^7 points\n", var == 0 ? "x" : "y");
+    benchIntegral<Euler, var>("Euler scalar", expXByY);
+    benchIntegral<Euler, var>("Euler batched<2>", batched<2>(expXByY));
+    benchIntegral<Euler, var>("Euler batched<4>", batched<4>(expXByY));
+    benchIntegral<Euler, var>("Euler batched<8>", batched<8>(expXByY));
+    benchIntegral<Simpson, var>("Simpson scalar", expXByY);
+    benchIntegral<Simpson, var>("Simpson batched<4>", batched<4>(expXByY));
+    std::printf("same on [0, 1], 10^3 points\n");
+    benchIntegral<Euler, var, 3>("Euler scalar", expXByY);
+    benchIntegral<Trapezoid, var, 3>("Trapezoid scalar", expXByY);
+    benchIntegral<Simpson, var, 3>("Simpson scalar", expXByY);
+    benchIntegral<Boole, var, 3>("Boole scalar", expXByY);
+    benchIntegral<GL3, var, 3>("GL3 scalar", expXByY);
+}
+
+// integral by y for many values of x: one call per value vs a single sweep
+void benchSweep() {
+    const auto range = discreteRange<4>(0.0, 1.0);
+    std::vector<double> xs (1000);
+    for (size_t i = 0; i < xs.size(); ++i) {
+        xs[i] = 0.001 * i;
+    }
+    std::printf("integral of exp(x)*y by y on [0, 1], 10^4 points, for %zu values of x\n", xs.size());
+    const auto report = [](const char* name, double ms) { std::printf("%-24s %10.3f ms\n", name, ms); };
+
+    const auto byY = integral<Simpson, 1>(expXByY);
+    report("per value", measureMs([&] {
+        std::vector<double> result (xs.size());
+        for (size_t i = 0; i < xs.size(); ++i) {
+            result[i] = byY(range, xs[i], dVar);
+        }
+        doNotOptimize(result);
+    }));
+    report("sweep scalar", measureMs([&] {
+        doNotOptimize(integralSweep<Simpson, 1>(expXByY)(range, xs, dVar, dVar));
+    }));
+    report("sweep batched<4>", measureMs([&] {
+        doNotOptimize(integralSweep<Simpson, 1>(batched<4>(expXByY))(range, xs, dVar, dVar));
+    }));
+    report("sweep batched<4> par", measureMs([&] {
+        doNotOptimize(integralSweep<Simpson, 1>(execution::par, batched<4>(expXByY))(range, xs, dVar, dVar));
+    }));
+}
+
+// 3D integral: nested integral objects vs a single tensor product traversal; 6D integral on a sparse grid
+void benchMultiIntegral() {
+    const auto f = [](auto x, auto y, auto z) { using std::exp; return exp(-(x * x + y * y + z * z)); };
+    const double exact1D = 0.74682413281242702540; // integral of exp(-x^2) over [0, 1]
+    const auto range = discreteRange<2>(0.0, 1.0);
+    const auto bench = [](const char* name, double exact, auto integrate) {
+        double value = 0;
+        const double ms = measureMs([&] { value = integrate(); doNotOptimize(value); });
+        std::printf("%-24s %10.3f ms   error %.3e\n", name, ms, std::abs(value - exact));
+    };
+    std::printf("integral of exp(-|x|^2) over [0, 1]^3, 10^2 points per axis\n");
+
+    const auto byZ = integral<Simpson, 2>(f);
+    const auto byYZ = integral<Simpson, 1>([&](double x, double y) { return byZ(range, x, y, dVar); });
+    const auto byXYZ = integral<Simpson>([&](double x) { return byYZ(range, x, dVar); });
+    bench("nested", std::pow(exact1D, 3), [&] { return byXYZ(range); });
+    const auto domains = std::make_tuple(range, range, range);
+    bench("tensor product", std::pow(exact1D, 3), [&] { return multiIntegral<Simpson>(f)(domains); });
+    bench("tensor product batched", std::pow(exact1D, 3), [&] {
+        return multiIntegral<Simpson>(batched<4>(f))(domains);
+    });
+
+    std::array<double, 6> from, to;
+    from.fill(0.0);
+    to.fill(1.0);
+    const auto g = [](auto a, auto b, auto c, auto d, auto e, auto h) {
+        using std::exp;
+        return exp(-(a * a + b * b + c * c + d * d + e * e + h * h));
+    };
+    const auto grid = CubatureRule<double, 6>::smolyak(5, from, to);
+    std::printf("same over [0, 1]^6, Smolyak grid of level 5 (%zu nodes)\n", grid.size());
+    bench("sparse grid", std::pow(exact1D, 6), [&] { return multiIntegral<Simpson>(g)(grid); });
+    bench("sparse grid batched", std::pow(exact1D, 6), [&] { return multiIntegral<Simpson>(batched<4>(g))(grid); });
+
+    const std::vector<std::pair<double, double>> box (6, { 0.0, 1.0 });
+    MonteCarloOptions<double> options;
+    options.relTol = 1e-4;
+    std::printf("same with Monte Carlo, relative tolerance 1e-4\n");
+    const auto monteCarlo = [&](const char* name, auto integrate) {
+        MonteCarloResult<double> result {};
+        const double ms = measureMs([&] { result = integrate(); doNotOptimize(result.value); });
+        std::printf("%-24s %10.3f ms   error %.3e (estimated %.3e, %zu samples)\n", name, ms,
+                    std::abs(result.value - std::pow(exact1D, 6)), result.error, result.samples);
+    };
+    monteCarlo("pseudo-random", [&] {
+        return monteCarloIntegral<PseudoRandom>(execution::par, batched<4>(g), options)(box, dVar, dVar, dVar, dVar,
+                                                                                       dVar, dVar);
+    });
+    monteCarlo("sobol", [&] {
+        return monteCarloIntegral<Sobol>(execution::par, batched<4>(g), options)(box, dVar, dVar, dVar, dVar, dVar,
+                                                                                dVar);
+    });
+    monteCarlo("halton", [&] {
+        return monteCarloIntegral<Halton>(execution::par, batched<4>(g), options)(box, dVar, dVar, dVar, dVar, dVar,
+                                                                                 dVar);
+    });
+}
+
+int main() {
+    benchAll<0>();
+    benchAll<1>();
+    benchSweep();
+    benchMultiIntegral();
+}
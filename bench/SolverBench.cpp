@@ -0,0 +1,249 @@
+#include <random>
+#include <string>
+
+#include <NumericalUtils.hpp>
+
+#include "BenchUtils.hpp"
+#include "../test/SparseProblems.hpp"
+
+using namespace nya;
+
+// the textbook elimination which eliminate() used before switching to LUFactorization
+template <typename T>
+std::vector<T> naiveEliminate(Surface<T>&& A) {
+    const size_t N = A.rowCount();
+    for (size_t i = 0; i < N; ++i) {
+        T maxEl = std::abs(A.at(i, i));
+        size_t maxRow = i;
+        for (size_t k = i + 1; k < N; ++k) {
+            if (std::abs(A.at(k, i)) > maxEl) {
+                maxEl = std::abs(A.at(k, i)); maxRow = k;
+            }
+        }
+        for (size_t k = i; k < N + 1; ++k) {
+            std::swap(A.at(maxRow, k), A.at(i, k));
+        }
+        for (size_t k = i + 1; k < N; ++k) {
+            const T c = -A.at(k, i) / A.at(i, i);
+            for (size_t j = i; j < N + 1; ++j) {
+                A.at(k, j) = i == j ? 0 : A.at(k, j) + c * A.at(i, j);
+            }
+        }
+    }
+    std::vector<T> solution (N);
+    for (ssize_t i = N - 1; i >= 0; --i) {
+        solution[i] = A.at(i, N) / A.at(i, i);
+        for (ssize_t k = i - 1; k >= 0; --k) {
+            A.at(k, N) -= A.at(k, i) * solution[i];
+        }
+    }
+    return solution;
+}
+
+// solves A x = A * ones for diagonally dominant A with exactly representable entries, returns time and max error
+template <typename T, typename Solve>
+std::pair<double, double> measureSolve(size_t n, Solve solve) {
+    std::mt19937 gen { 7 };
+    std::uniform_int_distribution<int> dist { -1024, 1024 };
+    Surface<T> A (n, n);
+    std::vector<T> b (n, T(0));
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            A.at(i, j) = T(dist(gen)) / 1024 + (i == j ? T(n) / 4 : T(0));
+            b[i] += A.at(i, j);
+        }
+    }
+    std::vector<T> x;
+    const double ms = measureMs([&] { x = solve(A, b); }, 1);
+    double error = 0;
+    for (const T xi : x) {
+        error = std::max(error, static_cast<double>(std::abs(xi - T(1))));
+    }
+    return { ms, error };
+}
+
+int main() {
+    std::mt19937 gen { 42 };
+    std::uniform_real_distribution<double> dist { -1.0, 1.0 };
+
+    std::printf("%zu worker threads\n", ThreadPool::instance().size());
+    std::printf("%6s %14s %14s %14s %14s %18s %14s %14s\n", "N", "naive, ms", "eliminate, ms", "factor, ms",
+                "factor par, ms", "solve 1 rhs, ms", "gemm par, ms", "gemv par, ms");
+    for (size_t n : { 100u, 200u, 500u, 1000u, 2000u }) {
+        Surface<double> augmented (n, n + 1);
+        for (auto& a : augmented) {
+            a = dist(gen);
+        }
+        Surface<double> A (n, n);
+        std::vector<double> b (n);
+        for (size_t i = 0; i < n; ++i) {
+            std::copy_n(&augmented.at(i, 0), n, &A.at(i, 0));
+            b[i] = augmented.at(i, n);
+        }
+
+        const int repeats = n <= 500 ? 5 : 1;
+        const double naiveMs = measureMs([&] { doNotOptimize(naiveEliminate(Surface<double> { augmented })); }, repeats);
+        const double eliminateMs = measureMs([&] { doNotOptimize(eliminate(Surface<double> { augmented })); }, repeats);
+        const double factorMs = measureMs([&] { doNotOptimize(LUFactorization<double> { A }); }, repeats);
+        const double parFactorMs = measureMs([&] { doNotOptimize(LUFactorization<double> { execution::par, A }); },
+                                             repeats);
+        const LUFactorization<double> lu { A };
+        const double solveMs = measureMs([&] { doNotOptimize(lu.solve(b)); }, 5);
+        const double gemmMs = measureMs([&] { doNotOptimize(multiply(execution::par, A, A)); }, repeats);
+        const double gemvMs = measureMs([&] { doNotOptimize(multiply(execution::par, A, b)); }, 5);
+        std::printf("%6zu %14.3f %14.3f %14.3f %14.3f %18.3f %14.3f %14.3f\n",
+                    n, naiveMs, eliminateMs, factorMs, parFactorMs, solveMs, gemmMs, gemvMs);
+    }
+
+    // banded systems, as produced by locally supported trial functions
+    std::printf("\n%8s %10s %16s %16s %16s\n", "N", "bandwidth", "thomas, ms", "band LU, ms", "auto, ms");
+    constexpr size_t maxDenseN = 3'000; // auto solver takes dense Surface: 72 MB at this size, 800 MB for 10^4
+    for (size_t n : { 1'000u, 3'000u, 10'000u, 100'000u }) {
+        for (size_t halfWidth : { 1u, 3u }) {
+            BandMatrix<double> A (n, halfWidth, halfWidth);
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = i > halfWidth ? i - halfWidth : 0; j < std::min(n, i + halfWidth + 1); ++j) {
+                    A.at(i, j) = i == j ? 2.0 * halfWidth + 1.0 : dist(gen);
+                }
+            }
+            const std::vector<double> b (n, 1.0);
+            double thomasMs = 0;
+            if (halfWidth == 1) {
+                std::vector<double> sub (n - 1), diagonal (n), super (n - 1);
+                for (size_t i = 0; i < n; ++i) {
+                    diagonal[i] = A.at(i, i);
+                    if (i + 1 < n) {
+                        sub[i] = A.at(i + 1, i);
+                        super[i] = A.at(i, i + 1);
+                    }
+                }
+                thomasMs = measureMs([&] { doNotOptimize(solveTridiagonal(sub, diagonal, super, b)); });
+            }
+            const double bandMs = measureMs([&] { doNotOptimize(BandLUFactorization<double> { A }.solve(b)); });
+            double autoMs = 0;
+            if (n <= maxDenseN) {
+                Surface<double> dense (n, n);
+                for (size_t i = 0; i < n; ++i) {
+                    for (size_t j = i > halfWidth ? i - halfWidth : 0; j < std::min(n, i + halfWidth + 1); ++j) {
+                        dense.at(i, j) = A.at(i, j);
+                    }
+                }
+                autoMs = measureMs([&] { doNotOptimize(solveLinearSystem(dense, b)); }, 1);
+            }
+            const auto column = [](double ms) {
+                char text[32] = "-";
+                if (ms > 0) {
+                    std::snprintf(text, sizeof(text), "%.3f", ms);
+                }
+                return std::string(text);
+            };
+            std::printf("%8zu %10zu %16s %16.3f %16s\n", n, 2 * halfWidth + 1,
+                        column(thomasMs).c_str(), bandMs, column(autoMs).c_str());
+        }
+    }
+
+    std::printf("\n%6s %16s %16s %16s %14s %18s\n", "N", "copy via at, ms", "convert, ms", "convert par, ms",
+                "in place, ms", "in place par, ms");
+    for (size_t n : { 500u, 1000u, 2000u, 4000u }) {
+        Surface<double> A (n, n);
+        for (auto& a : A) {
+            a = dist(gen);
+        }
+        const double naiveMs = measureMs([&] {
+            Surface<double, false> B (n, n);
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j < n; ++j) {
+                    B.at(i, j) = A.at(i, j);
+                }
+            }
+            doNotOptimize(B);
+        });
+        const double convertMs = measureMs([&] { doNotOptimize(convertLayout<false>(A)); });
+        const double convertParMs = measureMs([&] { doNotOptimize(convertLayout<false>(execution::par, A)); });
+        const double inPlaceMs = measureMs([&] { transposeInPlace(A); });
+        const double inPlaceParMs = measureMs([&] { transposeInPlace(execution::par, A); });
+        std::printf("%6zu %16.3f %16.3f %16.3f %14.3f %18.3f\n", n, naiveMs, convertMs, convertParMs, inPlaceMs,
+                    inPlaceParMs);
+    }
+
+    std::printf("\n%6s %-28s %12s %12s\n", "N", "precision (factor / result)", "time, ms", "max error");
+    for (size_t n : { 500u, 1000u, 2000u }) {
+        const auto row = [n](const char* name, std::pair<double, double> result) {
+            std::printf("%6zu %-28s %12.1f %12.2e\n", n, name, result.first, result.second);
+        };
+        row("float / float", measureSolve<float>(n, [](const auto& A, const auto& b) {
+            return LUFactorization<float> { execution::par, A }.solve(b);
+        }));
+        row("double / double", measureSolve<double>(n, [](const auto& A, const auto& b) {
+            return LUFactorization<double> { execution::par, A }.solve(b);
+        }));
+        row("float / double", measureSolve<double>(n, [](const auto& A, const auto& b) {
+            return solveMixedPrecision(execution::par, A, b);
+        }));
+        row("long double / long double", measureSolve<long double>(n, [](const auto& A, const auto& b) {
+            return LUFactorization<long double> { execution::par, A }.solve(b);
+        }));
+        row("double / long double", measureSolve<long double>(n, [](const auto& A, const auto& b) {
+            return solveMixedPrecision(execution::par, A, b);
+        }));
+        row("float / long double", measureSolve<long double>(n, [](const auto& A, const auto& b) {
+            return solveMixedPrecision<float>(execution::par, A, b);
+        }));
+#ifdef NUMUTILS_HAS_FLOAT128
+        if (n <= 500) { // software arithmetic
+            row("__float128 / __float128", measureSolve<__float128>(n, [](const auto& A, const auto& b) {
+                return LUFactorization<__float128> { execution::par, A }.solve(b);
+            }));
+        }
+        row("double / __float128", measureSolve<__float128>(n, [](const auto& A, const auto& b) {
+            return solveMixedPrecision(execution::par, A, b);
+        }));
+#endif
+    }
+
+    std::printf("\n%6s %10s %14s %20s %20s %20s\n", "grid", "unknowns", "band LU, ms", "CG jacobi, ms (it)",
+                "CG ILU0, ms (it)", "GMRES ILU0, ms (it)");
+    IterativeOptions<double> options;
+    options.relTol = 1e-8;
+    options.maxIterations = 10'000;
+    for (size_t grid : { 100u, 200u, 400u }) {
+        const auto poisson = convectionDiffusion(grid, 0.0);
+        const auto convection = convectionDiffusion(grid, 100.0);
+        std::vector<double> b (poisson.rows());
+        for (auto& v : b) {
+            v = dist(gen);
+        }
+        double bandMs = -1;
+        if (grid <= 200) {
+            BandMatrix<double> band (poisson.rows(), grid, grid);
+            for (size_t i = 0; i < poisson.rows(); ++i) {
+                for (size_t p = poisson.rowOffsets()[i]; p < poisson.rowOffsets()[i + 1]; ++p) {
+                    band.at(i, poisson.columnIndices()[p]) = poisson.values()[p];
+                }
+            }
+            bandMs = measureMs([&] { doNotOptimize(BandLUFactorization<double> { band }.solve(b)); }, 1);
+        }
+        IterativeResult<double> cgJacobi, cgIlu, gmresIlu;
+        const double cgJacobiMs = measureMs([&] {
+            cgJacobi = conjugateGradient(execution::par, poisson, b, JacobiPreconditioner<double> { poisson }, options);
+        }, 1);
+        const double cgIluMs = measureMs([&] {
+            cgIlu = conjugateGradient(execution::par, poisson, b, ILU0Preconditioner<double> { poisson }, options);
+        }, 1);
+        const double gmresIluMs = measureMs([&] {
+            gmresIlu = gmres(execution::par, convection, b, ILU0Preconditioner<double> { convection }, options);
+        }, 1);
+        const auto column = [](double ms, const IterativeResult<double>& result) {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%.1f (%zu)", ms, result.iterations);
+            return std::string(text);
+        };
+        char band[32] = "-";
+        if (bandMs >= 0) {
+            std::snprintf(band, sizeof(band), "%.1f", bandMs);
+        }
+        std::printf("%6zu %10zu %14s %20s %20s %20s\n", grid, poisson.rows(), band,
+                    column(cgJacobiMs, cgJacobi).c_str(), column(cgIluMs, cgIlu).c_str(),
+                    column(gmresIluMs, gmresIlu).c_str());
+    }
+}
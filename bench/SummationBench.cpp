@@ -0,0 +1,46 @@
+#include <NumericalUtils.hpp>
+
+#include "BenchUtils.hpp"
+
+using namespace nya;
+
+// rounding error is measured against the same Riemann sum computed in long double,
+// total error - against analytic value of the integral
+template <typename T>
+long double referenceSum(Range<T> range) {
+    long double sum = 0;
+    for (auto x : range) {
+        sum += static_cast<long double>(range.step()) * std::exp(static_cast<long double>(x));
+    }
+    return sum;
+}
+
+template <typename T, template <typename> typename Accumulator>
+void benchAccumulator(const char* name, Range<T> range, long double reference) {
+    const auto f = batched<nativeBatchSize<T>>([](auto x) { using std::exp; return exp(x); });
+    const auto integralOfF = integral<Euler, 0, T, Accumulator>(f);
+    T value = 0;
+    const double ms = measureMs([&] { value = integralOfF(range); doNotOptimize(value); }, 3);
+    std::printf("%-8s %-12s %10zu %10.3f ms   rounding %.3e   total %.3e\n",
+                sizeof(T) == sizeof(float) ? "float" : "double", name, range.count(), ms,
+                static_cast<double>(std::abs(value - reference)),
+                static_cast<double>(std::abs(value - (std::exp(1.0L) - 1.0L))));
+}
+
+template <typename T>
+void benchAll(size_t count) {
+    const auto range = Range<T> { 0, count, static_cast<T>(1) / count };
+    const auto reference = referenceSum(range);
+    benchAccumulator<T, NaiveSum>("naive", range, reference);
+    benchAccumulator<T, KahanSum>("kahan", range, reference);
+    benchAccumulator<T, NeumaierSum>("neumaier", range, reference);
+    benchAccumulator<T, PairwiseSum>("pairwise", range, reference);
+}
+
+int main() {
+    std::printf("Euler integral of exp(x) on [0, 1]\n");
+    for (size_t count : { 1'000u, 100'000u, 10'000'000u }) {
+        benchAll<float>(count);
+        benchAll<double>(count);
+    }
+}
@@ -0,0 +1,370 @@
+#ifndef NUMUTILS_AUTODIFF_HPP
+#define NUMUTILS_AUTODIFF_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "Batch.hpp"
+
+namespace nya {
+
+/**
+ * Truncated Taylor series a[0] + a[1]*t + ... + a[N]*t^N of a value depending on a variable x = x0 + t.
+ *
+ * Arithmetic and math functions propagate the whole series, so evaluating a generic function at
+ * Taylor::variable(x0) gives its derivatives at x0 exactly (up to rounding): f^(k)(x0) = k! * a[k]. Each operation
+ * costs O(N^2) operations on V instead of O(1), but no extra evaluations of the function are needed, and there
+ * is no truncation error and cancellation of finite differences. N = 1 gives dual numbers.
+ *
+ * Coefficients may be scalars or Batch values. Math functions are found via ADL, like for Batch, so functions
+ * should call them unqualified (using std::exp; exp(x)) to accept Taylor arguments.
+ * @tparam V - type of coefficients.
+ * @tparam N - degree of the series (highest order of derivatives).
+ */
+template <typename V, size_t N>
+struct Taylor {
+    using Value = V;
+
+    std::array<V, N + 1> a;
+
+    /**
+     * @brief Returns series of a constant value.
+     */
+    template <typename S>
+    static Taylor broadcast(S value) noexcept {
+        Taylor result;
+        result.a.fill(broadcastTo<V>(0));
+        result.a[0] = broadcastTo<V>(value);
+        return result;
+    }
+
+    /**
+     * @brief Returns series of the independent variable at x0, i.e. x0 + t.
+     */
+    static Taylor variable(V x0) noexcept {
+        Taylor result = broadcast(x0);
+        if constexpr (N > 0) {
+            result.a[1] = broadcastTo<V>(1);
+        }
+        return result;
+    }
+
+    static constexpr size_t degree() noexcept {
+        return N;
+    }
+
+    inline const V& value() const noexcept {
+        return a[0];
+    }
+
+    /**
+     * @brief Returns derivative of given order (k! * a[k]).
+     */
+    V derivative(size_t order) const noexcept {
+        V result = a[order];
+        for (size_t k = 2; k <= order; ++k) {
+            result *= static_cast<double>(k);
+        }
+        return result;
+    }
+
+    inline Taylor operator-() const noexcept {
+        Taylor result;
+        for (size_t k = 0; k <= N; ++k) { result.a[k] = -a[k]; }
+        return result;
+    }
+
+    inline Taylor& operator+=(const Taylor& other) noexcept {
+        for (size_t k = 0; k <= N; ++k) { a[k] += other.a[k]; }
+        return *this;
+    }
+
+    inline Taylor& operator-=(const Taylor& other) noexcept {
+        for (size_t k = 0; k <= N; ++k) { a[k] -= other.a[k]; }
+        return *this;
+    }
+
+    inline Taylor& operator*=(const Taylor& other) noexcept {
+        return *this = *this * other;
+    }
+
+    inline Taylor& operator/=(const Taylor& other) noexcept {
+        return *this = *this / other;
+    }
+
+    template <typename S, typename = std::enable_if_t<std::is_arithmetic_v<S> || std::is_same_v<S, V>>>
+    inline Taylor& operator+=(const S& value) noexcept {
+        a[0] += value;
+        return *this;
+    }
+
+    template <typename S, typename = std::enable_if_t<std::is_arithmetic_v<S> || std::is_same_v<S, V>>>
+    inline Taylor& operator-=(const S& value) noexcept {
+        a[0] -= value;
+        return *this;
+    }
+
+    template <typename S, typename = std::enable_if_t<std::is_arithmetic_v<S> || std::is_same_v<S, V>>>
+    inline Taylor& operator*=(const S& value) noexcept {
+        for (size_t k = 0; k <= N; ++k) { a[k] *= value; }
+        return *this;
+    }
+
+    template <typename S, typename = std::enable_if_t<std::is_arithmetic_v<S> || std::is_same_v<S, V>>>
+    inline Taylor& operator/=(const S& value) noexcept {
+        for (size_t k = 0; k <= N; ++k) { a[k] /= value; }
+        return *this;
+    }
+
+    /**
+     * Product of series (Cauchy product, truncated to degree N).
+     */
+    friend Taylor operator*(const Taylor& x, const Taylor& y) noexcept {
+        Taylor result;
+        for (size_t k = 0; k <= N; ++k) {
+            V sum = x.a[0] * y.a[k];
+            for (size_t j = 1; j <= k; ++j) {
+                sum += x.a[j] * y.a[k - j];
+            }
+            result.a[k] = sum;
+        }
+        return result;
+    }
+
+    /**
+     * Quotient of series: coefficients of r = x / y follow from x = r * y, one by one.
+     */
+    friend Taylor operator/(const Taylor& x, const Taylor& y) noexcept {
+        Taylor result;
+        for (size_t k = 0; k <= N; ++k) {
+            V sum = x.a[k];
+            for (size_t j = 1; j <= k; ++j) {
+                sum -= y.a[j] * result.a[k - j];
+            }
+            result.a[k] = sum / y.a[0];
+        }
+        return result;
+    }
+};
+
+/**
+ * Dual number v + v'*t, i.e. Taylor series of the first degree.
+ */
+template <typename V>
+using Dual = Taylor<V, 1>;
+
+template <typename X>
+struct IsTaylor : std::false_type {};
+
+template <typename V, size_t N>
+struct IsTaylor<Taylor<V, N>> : std::true_type {};
+
+/**
+ * True if X is Taylor.
+ */
+template <typename X>
+constexpr bool isTaylor = IsTaylor<std::decay_t<X>>::value;
+
+template <typename V, size_t N>
+inline Taylor<V, N> operator+(Taylor<V, N> x, const Taylor<V, N>& y) noexcept {
+    return x += y;
+}
+
+template <typename V, size_t N>
+inline Taylor<V, N> operator-(Taylor<V, N> x, const Taylor<V, N>& y) noexcept {
+    return x -= y;
+}
+
+/**
+ * True if S can be used as a constant in operations with Taylor<V, N>: arithmetic scalar or value of type V.
+ */
+template <typename S, typename V>
+constexpr bool isTaylorConstant = std::is_arithmetic_v<S> || std::is_same_v<S, V>;
+
+template <typename V, size_t N, typename S, typename = std::enable_if_t<isTaylorConstant<S, V>>>
+inline Taylor<V, N> operator+(Taylor<V, N> x, const S& c) noexcept {
+    return x += c;
+}
+
+template <typename V, size_t N, typename S, typename = std::enable_if_t<isTaylorConstant<S, V>>>
+inline Taylor<V, N> operator+(const S& c, Taylor<V, N> x) noexcept {
+    return x += c;
+}
+
+template <typename V, size_t N, typename S, typename = std::enable_if_t<isTaylorConstant<S, V>>>
+inline Taylor<V, N> operator-(Taylor<V, N> x, const S& c) noexcept {
+    return x -= c;
+}
+
+template <typename V, size_t N, typename S, typename = std::enable_if_t<isTaylorConstant<S, V>>>
+inline Taylor<V, N> operator-(const S& c, const Taylor<V, N>& x) noexcept {
+    return -x += c;
+}
+
+template <typename V, size_t N, typename S, typename = std::enable_if_t<isTaylorConstant<S, V>>>
+inline Taylor<V, N> operator*(Taylor<V, N> x, const S& c) noexcept {
+    return x *= c;
+}
+
+template <typename V, size_t N, typename S, typename = std::enable_if_t<isTaylorConstant<S, V>>>
+inline Taylor<V, N> operator*(const S& c, Taylor<V, N> x) noexcept {
+    return x *= c;
+}
+
+template <typename V, size_t N, typename S, typename = std::enable_if_t<isTaylorConstant<S, V>>>
+inline Taylor<V, N> operator/(Taylor<V, N> x, const S& c) noexcept {
+    return x /= c;
+}
+
+template <typename V, size_t N, typename S, typename = std::enable_if_t<isTaylorConstant<S, V>>>
+inline Taylor<V, N> operator/(const S& c, const Taylor<V, N>& x) noexcept {
+    return Taylor<V, N>::broadcast(c) / x;
+}
+
+/**
+ * Comparisons look at values only, so that branches of generic functions (e.g. piecewise definitions) take
+ * the same path as for plain scalars.
+ */
+#define NUMUTILS_TAYLOR_COMPARISON(op) \
+template <typename V, size_t N> \
+inline bool operator op(const Taylor<V, N>& x, const Taylor<V, N>& y) noexcept { return x.a[0] op y.a[0]; } \
+template <typename V, size_t N, typename S, typename = std::enable_if_t<isTaylorConstant<S, V>>> \
+inline bool operator op(const Taylor<V, N>& x, const S& c) noexcept { return x.a[0] op c; } \
+template <typename V, size_t N, typename S, typename = std::enable_if_t<isTaylorConstant<S, V>>> \
+inline bool operator op(const S& c, const Taylor<V, N>& x) noexcept { return c op x.a[0]; }
+
+NUMUTILS_TAYLOR_COMPARISON(<)
+NUMUTILS_TAYLOR_COMPARISON(>)
+NUMUTILS_TAYLOR_COMPARISON(<=)
+NUMUTILS_TAYLOR_COMPARISON(>=)
+
+#undef NUMUTILS_TAYLOR_COMPARISON
+
+/**
+ * Math functions of series are computed with recurrences for their coefficients, which follow from simple
+ * differential equations they satisfy (e.g. y = exp(x) => y' = y * x'); each is O(N^2).
+ */
+
+template <typename V, size_t N>
+Taylor<V, N> exp(const Taylor<V, N>& x) noexcept {
+    using std::exp;
+    Taylor<V, N> y;
+    y.a[0] = exp(x.a[0]);
+    for (size_t k = 1; k <= N; ++k) {
+        V sum = x.a[1] * y.a[k - 1];
+        for (size_t j = 2; j <= k; ++j) {
+            sum += static_cast<double>(j) * x.a[j] * y.a[k - j];
+        }
+        y.a[k] = sum / static_cast<double>(k);
+    }
+    return y;
+}
+
+template <typename V, size_t N>
+Taylor<V, N> log(const Taylor<V, N>& x) noexcept {
+    using std::log;
+    Taylor<V, N> y;
+    y.a[0] = log(x.a[0]);
+    for (size_t k = 1; k <= N; ++k) {
+        V sum = x.a[k] * static_cast<double>(k);
+        for (size_t j = 1; j < k; ++j) {
+            sum -= static_cast<double>(j) * y.a[j] * x.a[k - j];
+        }
+        y.a[k] = sum / (static_cast<double>(k) * x.a[0]);
+    }
+    return y;
+}
+
+template <typename V, size_t N>
+Taylor<V, N> sqrt(const Taylor<V, N>& x) noexcept {
+    using std::sqrt;
+    Taylor<V, N> y;
+    y.a[0] = sqrt(x.a[0]);
+    for (size_t k = 1; k <= N; ++k) {
+        V sum = x.a[k];
+        for (size_t j = 1; j < k; ++j) {
+            sum -= y.a[j] * y.a[k - j];
+        }
+        y.a[k] = sum / (2.0 * y.a[0]);
+    }
+    return y;
+}
+
+/**
+ * x^p for constant p (x should not be zero).
+ */
+template <typename V, size_t N, typename P, typename = std::enable_if_t<std::is_arithmetic_v<P>>>
+Taylor<V, N> pow(const Taylor<V, N>& x, P p) noexcept {
+    using std::pow;
+    const double power = static_cast<double>(p);
+    Taylor<V, N> y;
+    y.a[0] = pow(x.a[0], power);
+    for (size_t k = 1; k <= N; ++k) {
+        V sum = (power + 1.0 - static_cast<double>(k)) * x.a[1] * y.a[k - 1];
+        for (size_t j = 2; j <= k; ++j) {
+            sum += ((power + 1.0) * static_cast<double>(j) - static_cast<double>(k)) * x.a[j] * y.a[k - j];
+        }
+        y.a[k] = sum / (static_cast<double>(k) * x.a[0]);
+    }
+    return y;
+}
+
+namespace detail {
+
+/**
+ * Computes series of sin(x) and cos(x) together, as each one's recurrence needs the other one.
+ */
+template <typename V, size_t N>
+void sinCos(const Taylor<V, N>& x, Taylor<V, N>& s, Taylor<V, N>& c) noexcept {
+    using std::sin;
+    using std::cos;
+    s.a[0] = sin(x.a[0]);
+    c.a[0] = cos(x.a[0]);
+    for (size_t k = 1; k <= N; ++k) {
+        V sSum = x.a[1] * c.a[k - 1];
+        V cSum = x.a[1] * s.a[k - 1];
+        for (size_t j = 2; j <= k; ++j) {
+            sSum += static_cast<double>(j) * x.a[j] * c.a[k - j];
+            cSum += static_cast<double>(j) * x.a[j] * s.a[k - j];
+        }
+        s.a[k] = sSum / static_cast<double>(k);
+        c.a[k] = -cSum / static_cast<double>(k);
+    }
+}
+
+} // detail
+
+template <typename V, size_t N>
+Taylor<V, N> sin(const Taylor<V, N>& x) noexcept {
+    Taylor<V, N> s, c;
+    detail::sinCos(x, s, c);
+    return s;
+}
+
+template <typename V, size_t N>
+Taylor<V, N> cos(const Taylor<V, N>& x) noexcept {
+    Taylor<V, N> s, c;
+    detail::sinCos(x, s, c);
+    return c;
+}
+
+template <typename V, size_t N>
+Taylor<V, N> tan(const Taylor<V, N>& x) noexcept {
+    Taylor<V, N> s, c;
+    detail::sinCos(x, s, c);
+    return s / c;
+}
+
+/**
+ * |x| for scalar coefficients (derivative at zero is taken from the right).
+ */
+template <typename V, size_t N, typename = std::enable_if_t<std::is_arithmetic_v<V>>>
+Taylor<V, N> abs(const Taylor<V, N>& x) noexcept {
+    return x.a[0] < 0 ? -x : x;
+}
+
+} // nya
+
+#endif //NUMUTILS_AUTODIFF_HPP
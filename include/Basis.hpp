@@ -0,0 +1,367 @@
+#ifndef NUMUTILS_BASIS_HPP
+#define NUMUTILS_BASIS_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Batch.hpp"
+
+namespace nya {
+
+/**
+ * Bases of trial functions for Galerkin method.
+ *
+ * Every basis provides:
+ *  - size() - number of basis functions;
+ *  - evalAll(x, out) - writes values of all basis functions at x to out[0 .. size()), in one pass;
+ *  - combination(coefs) - function object for sum(coefs[i] * phi_i), evaluated without evaluating every phi_i.
+ * Bases of functions of the same type (ChebyshevBasis, PolynomialBasis) also provide:
+ *  - operator[](i) - i-th basis function as a standalone function object;
+ *  - functions() - all basis functions as a vector of such function objects.
+ * FunctionBasis holds functions of different types in a tuple and instead provides visit(i, g) and map(op).
+ * Arguments x may be scalars or Batch values.
+ */
+
+/**
+ * Chebyshev polynomial of the first kind T_order, evaluated with three-term recurrence in O(order) operations.
+ */
+struct ChebyshevPolynomial {
+    size_t order;
+
+    template <typename X>
+    X operator()(X x) const noexcept {
+        X previous = broadcastTo<X>(1);
+        if (order == 0) {
+            return previous;
+        }
+        X current = x;
+        for (size_t n = 1; n < order; ++n) {
+            const X next = 2 * x * current - previous;
+            previous = current;
+            current = next;
+        }
+        return current;
+    }
+};
+
+/**
+ * Linear combination of Chebyshev polynomials sum(coefs[n] * T_n(x)), evaluated with Clenshaw summation.
+ * @tparam T - type of coefficients.
+ */
+template <typename T>
+struct ChebyshevSeries {
+    std::vector<T> coefs;
+
+    template <typename X>
+    X operator()(X x) const noexcept {
+        X b1 = broadcastTo<X>(0), b2 = broadcastTo<X>(0);
+        if (coefs.empty()) {
+            return b1;
+        }
+        for (size_t n = coefs.size() - 1; n > 0; --n) {
+            const X b0 = coefs[n] + 2 * x * b1 - b2;
+            b2 = b1;
+            b1 = b0;
+        }
+        return coefs[0] + x * b1 - b2;
+    }
+};
+
+/**
+ * Chebyshev polynomials of the first kind T_0 .. T_maxOrder.
+ * @tparam T - floating point type of coefficients.
+ */
+template <typename T = double>
+class ChebyshevBasis {
+    size_t maxOrder_;
+
+public:
+    explicit ChebyshevBasis(size_t maxOrder) : maxOrder_(maxOrder) {
+    }
+
+    inline size_t size() const noexcept {
+        return maxOrder_ + 1;
+    }
+
+    inline size_t maxOrder() const noexcept {
+        return maxOrder_;
+    }
+
+    /**
+     * Writes T_0(x) .. T_maxOrder(x) to out, using T_{n+1} = 2x T_n - T_{n-1}.
+     */
+    template <typename X>
+    void evalAll(X x, X* out) const noexcept {
+        out[0] = broadcastTo<X>(1);
+        if (maxOrder_ > 0) {
+            out[1] = x;
+        }
+        for (size_t n = 2; n <= maxOrder_; ++n) {
+            out[n] = 2 * x * out[n - 1] - out[n - 2];
+        }
+    }
+
+    inline ChebyshevPolynomial operator[](size_t i) const noexcept {
+        return { i };
+    }
+
+    std::vector<ChebyshevPolynomial> functions() const {
+        std::vector<ChebyshevPolynomial> fns;
+        fns.reserve(size());
+        for (size_t i = 0; i < size(); ++i) {
+            fns.push_back((*this)[i]);
+        }
+        return fns;
+    }
+
+    ChebyshevSeries<T> combination(std::vector<T> coefs) const {
+        return { std::move(coefs) };
+    }
+};
+
+/**
+ * Monomial x^power, evaluated with binary exponentiation.
+ */
+struct Monomial {
+    size_t power;
+
+    template <typename X>
+    X operator()(X x) const noexcept {
+        X result = broadcastTo<X>(1);
+        for (size_t p = power; p > 0; p >>= 1) {
+            if (p & 1) {
+                result *= x;
+            }
+            x *= x;
+        }
+        return result;
+    }
+};
+
+/**
+ * Polynomial sum(coefs[n] * x^n), evaluated with Horner scheme.
+ * @tparam T - type of coefficients.
+ */
+template <typename T>
+struct PolynomialSeries {
+    std::vector<T> coefs;
+
+    template <typename X>
+    X operator()(X x) const noexcept {
+        X result = broadcastTo<X>(0);
+        for (size_t n = coefs.size(); n-- > 0;) {
+            result = result * x + coefs[n];
+        }
+        return result;
+    }
+};
+
+/**
+ * Monomials x^0 .. x^maxOrder.
+ * @tparam T - floating point type of coefficients.
+ */
+template <typename T = double>
+class PolynomialBasis {
+    size_t maxOrder_;
+
+public:
+    explicit PolynomialBasis(size_t maxOrder) : maxOrder_(maxOrder) {
+    }
+
+    inline size_t size() const noexcept {
+        return maxOrder_ + 1;
+    }
+
+    inline size_t maxOrder() const noexcept {
+        return maxOrder_;
+    }
+
+    /**
+     * Writes x^0 .. x^maxOrder to out, each power being the previous one times x.
+     */
+    template <typename X>
+    void evalAll(X x, X* out) const noexcept {
+        out[0] = broadcastTo<X>(1);
+        for (size_t n = 1; n <= maxOrder_; ++n) {
+            out[n] = out[n - 1] * x;
+        }
+    }
+
+    inline Monomial operator[](size_t i) const noexcept {
+        return { i };
+    }
+
+    std::vector<Monomial> functions() const {
+        std::vector<Monomial> fns;
+        fns.reserve(size());
+        for (size_t i = 0; i < size(); ++i) {
+            fns.push_back((*this)[i]);
+        }
+        return fns;
+    }
+
+    PolynomialSeries<T> combination(std::vector<T> coefs) const {
+        return { std::move(coefs) };
+    }
+};
+
+/**
+ * Linear combination sum(coefs[i] * f_i(x)) of functions of a FunctionBasis.
+ */
+template <typename T, typename ... Fs>
+struct FunctionCombination {
+    std::tuple<Fs...> fns;
+    std::vector<T> coefs;
+
+    template <typename X>
+    X operator()(X x) const {
+        return sum(x, std::index_sequence_for<Fs...> {});
+    }
+
+private:
+    template <typename X, size_t ... Is>
+    X sum(X x, std::index_sequence<Is...>) const {
+        X result = broadcastTo<X>(0);
+        ((result += coefs[Is] * std::get<Is>(fns)(x)), ...);
+        return result;
+    }
+};
+
+/**
+ * Basis of a fixed set of function objects of arbitrary types, known at compile time.
+ *
+ * Functions are stored in a tuple and evaluated with fold expressions, so that evaluation of the whole basis
+ * (e.g. in Galerkin assembly loop) is inlined, without indirect calls of std::function.
+ * @tparam T - floating point type of coefficients.
+ * @tparam Fs - types of function objects.
+ */
+template <typename T, typename ... Fs>
+class FunctionBasis {
+    std::tuple<Fs...> fns_;
+
+public:
+    explicit FunctionBasis(std::tuple<Fs...> fns) : fns_(std::move(fns)) {
+    }
+
+    static constexpr size_t size() noexcept {
+        return sizeof...(Fs);
+    }
+
+    /**
+     * Writes f_0(x) .. f_{size() - 1}(x) to out.
+     */
+    template <typename X>
+    void evalAll(X x, X* out) const {
+        evalAll(x, out, std::index_sequence_for<Fs...> {});
+    }
+
+    /**
+     * @brief Returns tuple of functions.
+     */
+    inline const std::tuple<Fs...>& functions() const noexcept {
+        return fns_;
+    }
+
+    /**
+     * Calls g(f_i) for run time index i.
+     */
+    template <typename G>
+    void visit(size_t i, G&& g) const {
+        visit(i, g, std::index_sequence_for<Fs...> {});
+    }
+
+    /**
+     * @brief Returns basis of op(f_0) .. op(f_{size() - 1}).
+     */
+    template <typename Op>
+    auto map(const Op& op) const {
+        return std::apply([&op](const auto& ... f) {
+            return FunctionBasis<T, decltype(op(f))...> { std::make_tuple(op(f)...) };
+        }, fns_);
+    }
+
+    FunctionCombination<T, Fs...> combination(std::vector<T> coefs) const {
+        return { fns_, std::move(coefs) };
+    }
+
+private:
+    template <typename X, size_t ... Is>
+    void evalAll(X x, X* out, std::index_sequence<Is...>) const {
+        ((out[Is] = broadcastTo<X>(std::get<Is>(fns_)(x))), ...);
+    }
+
+    template <typename G, size_t ... Is>
+    void visit(size_t i, G& g, std::index_sequence<Is...>) const {
+        ((i == Is ? (g(std::get<Is>(fns_)), 0) : 0), ...);
+    }
+};
+
+/**
+ * Makes basis of given function objects (see FunctionBasis).
+ * @tparam T - floating point type of coefficients.
+ */
+template <typename T = double, typename ... Fs>
+auto makeBasis(Fs ... fns) {
+    return FunctionBasis<T, Fs...> { std::make_tuple(std::move(fns)...) };
+}
+
+template <typename B, typename = void>
+struct IsBasis : std::false_type {};
+
+template <typename B>
+struct IsBasis<B, std::void_t<
+    decltype(std::declval<const B&>().size()),
+    decltype(std::declval<const B&>().evalAll(0.0, std::declval<double*>())),
+    decltype(&B::combination)
+>> : std::true_type {};
+
+/**
+ * True if B provides the basis interface (see above).
+ */
+template <typename B>
+constexpr bool isBasis = IsBasis<std::decay_t<B>>::value;
+
+template <typename B>
+struct IsFunctionBasis : std::false_type {};
+
+template <typename T, typename ... Fs>
+struct IsFunctionBasis<FunctionBasis<T, Fs...>> : std::true_type {};
+
+template <typename B>
+constexpr bool isFunctionBasis = IsFunctionBasis<std::decay_t<B>>::value;
+
+/**
+ * Evaluates f at every point of [first, last), writing results to out, N points at a time.
+ *
+ * f is called with Batch<T, N> arguments (remaining points are evaluated one by one), so it should accept both
+ * scalars and batches; combinations of basis functions do.
+ * @tparam N - batch size.
+ * @return iterator past the last written result.
+ */
+template <size_t N = nativeBatchSize<double>, typename F, typename InputIt, typename OutputIt>
+OutputIt tabulate(const F& f, InputIt first, InputIt last, OutputIt out) {
+    using T = std::decay_t<decltype(*first)>;
+    size_t count = std::distance(first, last);
+    for (; count >= N; count -= N) {
+        Batch<T, N> x;
+        for (size_t i = 0; i < N; ++i, ++first) {
+            x[i] = *first;
+        }
+        const auto y = asBatch<T, N>(f(x));
+        for (size_t i = 0; i < N; ++i, ++out) {
+            *out = y[i];
+        }
+    }
+    for (; first != last; ++first, ++out) {
+        *out = f(*first);
+    }
+    return out;
+}
+
+} // nya
+
+#endif //NUMUTILS_BASIS_HPP
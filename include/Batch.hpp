@@ -0,0 +1,277 @@
+#ifndef NUMUTILS_BATCH_HPP
+#define NUMUTILS_BATCH_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include <iterator>
+#include <utility>
+
+namespace nya {
+
+/**
+ * Fixed-width pack of values, processed lane by lane.
+ *
+ * Stored as GCC/Clang vector extension type, so arithmetic on batches compiles directly to SIMD instructions
+ * available for the target (plain loops over lanes are often left scalar by compilers). Math functions (exp, sin, ...)
+ * are found via ADL, so generic function objects should call them unqualified (using std::exp; exp(x)) to work with
+ * both scalars and batches.
+ * @tparam T - floating point type of lanes (float or double).
+ * @tparam N - number of lanes (power of two).
+ */
+template <typename T, size_t N>
+struct Batch {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "Batch supports only float and double");
+    static_assert(N > 0 && (N & (N - 1)) == 0, "Batch size should be a power of two");
+
+    typedef T Vector __attribute__((vector_size(sizeof(T) * N)));
+
+    Vector v;
+
+    static constexpr size_t size() noexcept {
+        return N;
+    }
+
+    static Batch broadcast(T value) noexcept {
+        return { Vector {} + value };
+    }
+
+    inline T& operator[](size_t i) noexcept {
+        return v[i];
+    }
+
+    inline T operator[](size_t i) const noexcept {
+        return v[i];
+    }
+
+    /**
+     * @brief Returns sum of all lanes.
+     */
+    inline T sum() const noexcept {
+        T result = 0;
+        for (size_t i = 0; i < N; ++i) { result += v[i]; }
+        return result;
+    }
+
+#define NUMUTILS_BATCH_COMPOUND_OP(op) \
+    inline Batch& operator op(const Batch& other) noexcept { v op other.v; return *this; } \
+    inline Batch& operator op(T value) noexcept { v op value; return *this; }
+
+    NUMUTILS_BATCH_COMPOUND_OP(+=)
+    NUMUTILS_BATCH_COMPOUND_OP(-=)
+    NUMUTILS_BATCH_COMPOUND_OP(*=)
+    NUMUTILS_BATCH_COMPOUND_OP(/=)
+
+#undef NUMUTILS_BATCH_COMPOUND_OP
+
+    inline Batch operator-() const noexcept {
+        return { -v };
+    }
+};
+
+#define NUMUTILS_BATCH_BINARY_OP(op) \
+template <typename T, size_t N> \
+inline Batch<T, N> operator op(const Batch<T, N>& a, const Batch<T, N>& b) noexcept { return { a.v op b.v }; } \
+template <typename T, size_t N, typename S, typename = std::enable_if_t<std::is_arithmetic_v<S>>> \
+inline Batch<T, N> operator op(const Batch<T, N>& a, S b) noexcept { return { a.v op static_cast<T>(b) }; } \
+template <typename T, size_t N, typename S, typename = std::enable_if_t<std::is_arithmetic_v<S>>> \
+inline Batch<T, N> operator op(S a, const Batch<T, N>& b) noexcept { return { static_cast<T>(a) op b.v }; }
+
+NUMUTILS_BATCH_BINARY_OP(+)
+NUMUTILS_BATCH_BINARY_OP(-)
+NUMUTILS_BATCH_BINARY_OP(*)
+NUMUTILS_BATCH_BINARY_OP(/)
+
+#undef NUMUTILS_BATCH_BINARY_OP
+
+#define NUMUTILS_BATCH_UNARY_FN(fn) \
+template <typename T, size_t N> \
+inline Batch<T, N> fn(const Batch<T, N>& x) noexcept { \
+    Batch<T, N> r; \
+    for (size_t i = 0; i < N; ++i) { r[i] = std::fn(x[i]); } \
+    return r; \
+}
+
+NUMUTILS_BATCH_UNARY_FN(sqrt)
+NUMUTILS_BATCH_UNARY_FN(log)
+NUMUTILS_BATCH_UNARY_FN(sin)
+NUMUTILS_BATCH_UNARY_FN(cos)
+NUMUTILS_BATCH_UNARY_FN(tan)
+
+#undef NUMUTILS_BATCH_UNARY_FN
+
+template <typename T, size_t N>
+inline Batch<T, N> abs(const Batch<T, N>& x) noexcept {
+    return { x.v < 0 ? -x.v : x.v };
+}
+
+template <typename T, size_t N>
+inline Batch<T, N> min(const Batch<T, N>& a, const Batch<T, N>& b) noexcept {
+    return { b.v < a.v ? b.v : a.v };
+}
+
+template <typename T, size_t N>
+inline Batch<T, N> max(const Batch<T, N>& a, const Batch<T, N>& b) noexcept {
+    return { a.v < b.v ? b.v : a.v };
+}
+
+/**
+ * Converts value to Batch<T, N>: scalars are broadcast to all lanes, batches are passed through.
+ *
+ * Useful for results of batched functions, which may legitimately return a scalar (e.g. a constant).
+ */
+template <typename T, size_t N, typename V>
+inline Batch<T, N> asBatch(const V& value) noexcept {
+    if constexpr (std::is_arithmetic_v<V>) {
+        return Batch<T, N>::broadcast(static_cast<T>(value));
+    } else {
+        return value;
+    }
+}
+
+/**
+ * Converts value to X, which is either a scalar type or Batch: scalars are broadcast to all lanes of batches,
+ * values of type X are passed through.
+ *
+ * Useful for constants in generic code, which works on both scalars and batches.
+ */
+template <typename X, typename T>
+inline X broadcastTo(T value) noexcept {
+    if constexpr (std::is_same_v<T, X>) {
+        return value;
+    } else if constexpr (std::is_arithmetic_v<X>) {
+        return static_cast<X>(value);
+    } else {
+        return X::broadcast(value);
+    }
+}
+
+namespace detail {
+
+/**
+ * Branch-free exp for doubles in [-708, 709], accurate to about one ulp.
+ *
+ * Unlike a loop calling std::exp, this is a sequence of whole-batch operations, i.e. SIMD instructions.
+ * x = n*ln2 + r, |r| <= ln2/2; e^r is evaluated as degree-13 Taylor polynomial and scaled by 2^n, which is
+ * constructed directly in exponent bits.
+ */
+template <size_t N>
+inline Batch<double, N> expKernel(const Batch<double, N>& x) noexcept {
+    constexpr double log2e = 1.4426950408889634074;
+    constexpr double ln2Hi = 6.93147180369123816490e-01;
+    constexpr double ln2Lo = 1.90821492927058770002e-10;
+    constexpr double shifter = 0x1.8p52; // adding it rounds to integer and puts it into low mantissa bits
+    constexpr double inverseFactorials[] = {
+        1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0,
+        1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 0.5, 1.0, 1.0
+    };
+    typedef int64_t Bits __attribute__((vector_size(sizeof(double) * N)));
+
+    const auto t = x.v * log2e + shifter;
+    const auto n = t - shifter;
+    const auto r = (x.v - n * ln2Hi) - n * ln2Lo;
+
+    auto p = r - r + inverseFactorials[0];
+    for (size_t i = 1; i < std::size(inverseFactorials); ++i) {
+        p = p * r + inverseFactorials[i];
+    }
+
+    const Bits scale = ((Bits) t + 1023) << 52; // vector casts reinterpret bits
+    return { p * (typename Batch<double, N>::Vector) scale };
+}
+
+} // detail
+
+template <typename T, size_t N>
+inline Batch<T, N> exp(const Batch<T, N>& x) noexcept {
+    Batch<T, N> r;
+    if constexpr (std::is_same_v<T, double>) {
+        const auto lo = Batch<T, N>::broadcast(-708.0), hi = Batch<T, N>::broadcast(709.0);
+        r = detail::expKernel(min(max(x, lo), hi));
+        // out of kernel range (overflow, subnormals, NaN) - rare, fall back to std::exp
+        for (size_t i = 0; i < N; ++i) {
+            if (!(x[i] >= -708.0 && x[i] <= 709.0)) {
+                r[i] = std::exp(x[i]);
+            }
+        }
+    } else {
+        for (size_t i = 0; i < N; ++i) { r[i] = std::exp(x[i]); }
+    }
+    return r;
+}
+
+template <typename T, size_t N, typename P>
+inline Batch<T, N> pow(const Batch<T, N>& x, P p) noexcept {
+    Batch<T, N> r;
+    for (size_t i = 0; i < N; ++i) { r[i] = std::pow(x[i], p); }
+    return r;
+}
+
+/**
+ * Width of the widest SIMD register of compilation target, in bytes.
+ */
+#if defined(__AVX512F__)
+constexpr size_t nativeVectorBytes = 64;
+#elif defined(__AVX__)
+constexpr size_t nativeVectorBytes = 32;
+#else
+constexpr size_t nativeVectorBytes = 16;
+#endif
+
+/**
+ * Default number of lanes for type T: fills one SIMD register of compilation target.
+ */
+template <typename T>
+constexpr size_t nativeBatchSize = nativeVectorBytes / sizeof(T);
+
+/**
+ * Function object wrapper, which marks f as callable with Batch<T, N> arguments.
+ *
+ * Generic lambdas can not be reliably probed for this (their bodies are instantiated during the check), so batch
+ * evaluation paths are opt-in via batched<N>(f).
+ */
+template <typename F, size_t N>
+struct Batched {
+    static constexpr size_t batchSize = N;
+
+    F f;
+
+    template <typename ... Args>
+    inline auto operator()(Args&& ... x) const -> decltype(f(std::forward<Args>(x)...)) {
+        return f(std::forward<Args>(x)...);
+    }
+
+    template <typename ... Args>
+    inline auto operator()(Args&& ... x) -> decltype(f(std::forward<Args>(x)...)) {
+        return f(std::forward<Args>(x)...);
+    }
+};
+
+/**
+ * Marks function as being able to work on batches of N values.
+ * @tparam N - batch size.
+ * @tparam F - type of function object (usually deduced).
+ * @param f - function object, which should accept both scalars and Batch<T, N> arguments.
+ * @return Batched wrapper around f.
+ */
+template <size_t N = nativeBatchSize<double>, typename F>
+auto batched(F f) {
+    return Batched<F, N> { std::move(f) };
+}
+
+template <typename F>
+struct BatchSizeOf : std::integral_constant<size_t, 0> {};
+
+template <typename F, size_t N>
+struct BatchSizeOf<Batched<F, N>> : std::integral_constant<size_t, N> {};
+
+/**
+ * Batch size declared by function object type F (0 if it does not support batches).
+ */
+template <typename F>
+constexpr size_t batchSizeOf = BatchSizeOf<std::decay_t<F>>::value;
+
+} // nya
+
+#endif //NUMUTILS_BATCH_HPP
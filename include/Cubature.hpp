@@ -0,0 +1,232 @@
+#ifndef NUMUTILS_CUBATURE_HPP
+#define NUMUTILS_CUBATURE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Batch.hpp"
+#include "Quadrature.hpp"
+#include "Summation.hpp"
+
+namespace nya {
+
+/**
+ * Cubature rule in D dimensions: integral of f over a box is approximated by sum(weights[i] * f(nodes[i])).
+ *
+ * Nodes are stored point by point in one contiguous array (D coordinates each). Can be passed to multiIntegral
+ * in place of a tuple of ranges.
+ * @tparam T - floating point type.
+ * @tparam D - number of dimensions.
+ */
+template <typename T, size_t D>
+class CubatureRule {
+    static_assert(D > 0, "Cubature rule should have at least one dimension");
+
+    std::vector<T> nodes_;
+    std::vector<T> weights_;
+
+public:
+    CubatureRule() = default;
+
+    /**
+     * @param nodes - coordinates of nodes, point by point (weights.size() * D values).
+     * @param weights - weights of nodes.
+     */
+    CubatureRule(std::vector<T> nodes, std::vector<T> weights)
+        : nodes_(std::move(nodes)), weights_(std::move(weights)) {
+    }
+
+    /**
+     * Builds Smolyak sparse grid of given level on box [from, to], using nested Clenshaw-Curtis rules
+     * of 1, 3, 5, 9, ... points.
+     *
+     * The rule is a combination of tensor products of 1D rules with sum of levels near the given one, so that it
+     * needs O(2^level * level^(D-1)) nodes instead of O(2^(level*D)) of the full tensor product, and is exact for
+     * polynomials of total degree up to 2*level + 1. Nodes shared by several tensor products are merged.
+     * @param level - level of the grid (0 - a single node at the center).
+     * @param from - lower corner of the box.
+     * @param to - upper corner of the box.
+     */
+    static CubatureRule smolyak(size_t level, const std::array<T, D>& from, const std::array<T, D>& to) {
+        // 1D rules on [-1, 1] of levels 1 .. level + 1
+        std::vector<QuadratureRule<T>> rules;
+        for (size_t i = 1; i <= level + 1; ++i) {
+            rules.push_back(QuadratureRule<T>::clenshawCurtis(i == 1 ? 1 : (size_t(1) << (i - 1)) + 1, -1, 1));
+        }
+
+        std::map<std::array<T, D>, T> merged;
+        for (size_t sum = level + D; sum >= std::max(D, level + 1); --sum) {
+            // combination technique: (-1)^(level + D - sum) * C(D - 1, level + D - sum)
+            const size_t k = level + D - sum;
+            T coefficient = 1;
+            for (size_t j = 0; j < k; ++j) {
+                coefficient = coefficient * (D - 1 - j) / (j + 1);
+            }
+            if (k % 2 == 1) {
+                coefficient = -coefficient;
+            }
+            forEachLevels(sum, [&](const std::array<size_t, D>& levels) {
+                addTensorProduct(rules, levels, coefficient, merged);
+            });
+        }
+
+        T volumeScale = 1;
+        for (size_t k = 0; k < D; ++k) {
+            volumeScale *= (to[k] - from[k]) / 2;
+        }
+        std::vector<T> nodes, weights;
+        nodes.reserve(merged.size() * D);
+        weights.reserve(merged.size());
+        for (const auto& [node, weight] : merged) {
+            if (weight == 0) {
+                continue;
+            }
+            for (size_t k = 0; k < D; ++k) {
+                nodes.push_back((from[k] + to[k]) / 2 + (to[k] - from[k]) / 2 * node[k]);
+            }
+            weights.push_back(weight * volumeScale);
+        }
+        return CubatureRule { std::move(nodes), std::move(weights) };
+    }
+
+    static constexpr size_t dimension() noexcept {
+        return D;
+    }
+
+    inline size_t size() const noexcept {
+        return weights_.size();
+    }
+
+    inline const std::vector<T>& nodes() const noexcept {
+        return nodes_;
+    }
+
+    inline const std::vector<T>& weights() const noexcept {
+        return weights_;
+    }
+
+    /**
+     * @brief Returns pointer to D coordinates of i-th node.
+     */
+    inline const T* node(size_t i) const noexcept {
+        return nodes_.data() + i * D;
+    }
+
+    /**
+     * Applies rule to nodes [first, last) of f (function object of D arguments).
+     *
+     * If f supports batches (see batched()), nodes and weights are loaded batchSizeOf<F> at a time, and the sum
+     * is accumulated in batch lanes; the remaining nodes are processed one by one.
+     */
+    template <template <typename> typename Accumulator = NaiveSum, typename F>
+    T integrate(const F& f, size_t first, size_t last) const {
+        Accumulator<T> acc;
+        if constexpr (constexpr size_t N = batchSizeOf<F>; N > 0) {
+            Accumulator<Batch<T, N>> batchAcc;
+            for (; first + N <= last; first += N) {
+                std::array<Batch<T, N>, D> x;
+                Batch<T, N> w;
+                for (size_t lane = 0; lane < N; ++lane) {
+                    for (size_t k = 0; k < D; ++k) {
+                        x[k][lane] = node(first + lane)[k];
+                    }
+                    w[lane] = weights_[first + lane];
+                }
+                batchAcc.add(w * asBatch<T, N>(call(f, x.data(), std::make_index_sequence<D> {})));
+            }
+            const auto lanes = batchAcc.result();
+            for (size_t lane = 0; lane < N; ++lane) {
+                acc.add(lanes[lane]);
+            }
+        }
+        for (; first < last; ++first) {
+            acc.add(weights_[first] * call(f, node(first), std::make_index_sequence<D> {}));
+        }
+        return acc.result();
+    }
+
+    /**
+     * Applies rule to f (function object of D arguments).
+     */
+    template <template <typename> typename Accumulator = NaiveSum, typename F>
+    T integrate(const F& f) const {
+        return integrate<Accumulator>(f, 0, size());
+    }
+
+private:
+    template <typename F, typename X, size_t ... I>
+    static inline auto call(const F& f, const X* x, std::index_sequence<I...>) {
+        return f(x[I]...);
+    }
+
+    /**
+     * Calls f for every multi-index of levels >= 1 with the given sum (C(sum - 1, D - 1) of them): the first D - 1
+     * levels run through the simplex as an odometer, the last one takes the rest of the sum.
+     */
+    template <typename F>
+    static void forEachLevels(size_t sum, F&& f) {
+        std::array<size_t, D> levels;
+        levels.fill(1);
+        size_t head = D - 1; // sum of all levels but the last one
+        for (;;) {
+            levels[D - 1] = sum - head;
+            f(std::as_const(levels));
+
+            size_t axis = 0;
+            while (axis + 1 < D && head + 1 >= sum) {
+                head -= levels[axis] - 1;
+                levels[axis++] = 1;
+            }
+            if (axis + 1 >= D) {
+                return;
+            }
+            ++levels[axis];
+            ++head;
+        }
+    }
+
+    static void addTensorProduct(const std::vector<QuadratureRule<T>>& rules, const std::array<size_t, D>& levels,
+                                 T coefficient, std::map<std::array<T, D>, T>& merged) {
+        std::array<size_t, D> index {};
+        for (;;) {
+            std::array<T, D> node;
+            T weight = coefficient;
+            for (size_t k = 0; k < D; ++k) {
+                const auto& rule = rules[levels[k] - 1];
+                node[k] = rule.nodes()[index[k]];
+                weight *= rule.weights()[index[k]];
+            }
+            merged[node] += weight;
+
+            size_t axis = 0;
+            while (axis < D && index[axis] + 1 == rules[levels[axis] - 1].size()) {
+                index[axis++] = 0;
+            }
+            if (axis == D) {
+                return;
+            }
+            ++index[axis];
+        }
+    }
+};
+
+template <typename R>
+struct IsCubatureRule : std::false_type {};
+
+template <typename T, size_t D>
+struct IsCubatureRule<CubatureRule<T, D>> : std::true_type {};
+
+/**
+ * True if R is CubatureRule.
+ */
+template <typename R>
+constexpr bool isCubatureRule = IsCubatureRule<std::decay_t<R>>::value;
+
+} // nya
+
+#endif //NUMUTILS_CUBATURE_HPP
@@ -0,0 +1,1234 @@
+#ifndef NUMUTILS_LINEARALGEBRA_HPP
+#define NUMUTILS_LINEARALGEBRA_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "PrecisionTraits.hpp"
+#include "Surface.hpp"
+#include "ThreadPool.hpp"
+
+namespace nya {
+
+/**
+ * Dense linear algebra on Surface.
+ *
+ * Surfaces are treated as matrices with sizeX() rows and sizeY() columns, so that at(i, j) is the element in
+ * row i and column j regardless of the storage order.
+ */
+
+namespace detail {
+
+/**
+ * Non-owning view of a matrix block (see SurfaceView).
+ */
+template <typename T>
+using StridedMatrix = SurfaceView<T>;
+
+template <typename T, bool rowMajor, typename Alloc>
+StridedMatrix<T> stridedMatrix(Surface<T, rowMajor, Alloc>& s) noexcept {
+    return s.view();
+}
+
+template <typename T, bool rowMajor, typename Alloc>
+StridedMatrix<const T> stridedMatrix(const Surface<T, rowMajor, Alloc>& s) noexcept {
+    return s.view();
+}
+
+/**
+ * Tile sizes of gemm: C is split into rowTile x columnTile tiles, which are computed independently; the inner
+ * dimension is processed depthTile at a time, so that packed blocks of A and B stay in cache.
+ */
+constexpr size_t gemmRowTile = 64;
+constexpr size_t gemmColumnTile = 128;
+constexpr size_t gemmDepthTile = 128;
+
+/**
+ * Rows of A processed by a single gemv task.
+ */
+constexpr size_t gemvRowTile = 256;
+
+/**
+ * Rows of triangular matrix solved by substitution at once by trsm; the rest is updated with gemm / gemv.
+ */
+constexpr size_t trsmBlockSize = 64;
+
+/**
+ * Copies block of M into contiguous row-major buffer.
+ */
+template <typename T>
+void pack(const StridedMatrix<const T>& M, T* out) noexcept {
+    if (M.columnStride == 1) {
+        for (size_t i = 0; i < M.rows; ++i) {
+            std::copy_n(&M(i, 0), M.columns, out + i * M.columns);
+        }
+    } else {
+        for (size_t j = 0; j < M.columns; ++j) {
+            for (size_t i = 0; i < M.rows; ++i) {
+                out[i * M.columns + j] = M(i, j);
+            }
+        }
+    }
+}
+
+/**
+ * c[rows x columns] += a[rows x depth] * b[depth x columns], all row-major and contiguous.
+ * Four rows of b are applied per pass over a row of c.
+ */
+template <typename T>
+void multiplyPacked(const T* a, const T* b, T* c, size_t rows, size_t depth, size_t columns) noexcept {
+    for (size_t i = 0; i < rows; ++i) {
+        const T* ai = a + i * depth;
+        T* ci = c + i * columns;
+        size_t k = 0;
+        for (; k + 4 <= depth; k += 4) {
+            const T a0 = ai[k], a1 = ai[k + 1], a2 = ai[k + 2], a3 = ai[k + 3];
+            const T *b0 = b + k * columns, *b1 = b0 + columns, *b2 = b1 + columns, *b3 = b2 + columns;
+            for (size_t j = 0; j < columns; ++j) {
+                ci[j] += (a0 * b0[j] + a1 * b1[j]) + (a2 * b2[j] + a3 * b3[j]);
+            }
+        }
+        for (; k < depth; ++k) {
+            const T ak = ai[k];
+            const T* bk = b + k * columns;
+            for (size_t j = 0; j < columns; ++j) {
+                ci[j] += ak * bk[j];
+            }
+        }
+    }
+}
+
+/**
+ * C += alpha * A * B. C must not overlap with A or B.
+ */
+template <typename Policy, typename T>
+void gemm(Policy policy, T alpha, StridedMatrix<const T> A, StridedMatrix<const T> B, StridedMatrix<T> C) {
+    const size_t rowTiles = (C.rows + gemmRowTile - 1) / gemmRowTile;
+    const size_t columnTiles = (C.columns + gemmColumnTile - 1) / gemmColumnTile;
+    forEachIndex(policy, rowTiles * columnTiles, [&](size_t tile) {
+        const size_t i0 = tile / columnTiles * gemmRowTile, j0 = tile % columnTiles * gemmColumnTile;
+        const size_t rows = std::min(gemmRowTile, C.rows - i0), columns = std::min(gemmColumnTile, C.columns - j0);
+        // packed tiles are taken from the worker's arena, so repeated calls do not allocate
+        ArenaScope scope;
+        T* a = scope.allocate<T>(rows * gemmDepthTile);
+        T* b = scope.allocate<T>(gemmDepthTile * columns);
+        T* c = scope.allocate<T>(rows * columns);
+        std::fill_n(c, rows * columns, T(0));
+        for (size_t k0 = 0; k0 < A.columns; k0 += gemmDepthTile) {
+            const size_t depth = std::min(gemmDepthTile, A.columns - k0);
+            pack(A.block(i0, k0, rows, depth), a);
+            pack(B.block(k0, j0, depth, columns), b);
+            multiplyPacked(a, b, c, rows, depth, columns);
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < columns; ++j) {
+                C(i0 + i, j0 + j) += alpha * c[i * columns + j];
+            }
+        }
+    });
+}
+
+/**
+ * y += alpha * A * x, x and y are contiguous and must not overlap with A.
+ */
+template <typename Policy, typename T>
+void gemv(Policy policy, T alpha, StridedMatrix<const T> A, const T* x, T* y) {
+    const size_t tiles = (A.rows + gemvRowTile - 1) / gemvRowTile;
+    forEachIndex(policy, tiles, [&](size_t tile) {
+        const size_t i0 = tile * gemvRowTile, i1 = std::min(i0 + gemvRowTile, A.rows);
+        if (A.columnStride == 1) {
+            // row-major: dot product per row
+            for (size_t i = i0; i < i1; ++i) {
+                const T* ai = &A(i, 0);
+                T s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+                size_t j = 0;
+                for (; j + 4 <= A.columns; j += 4) {
+                    s0 += ai[j] * x[j]; s1 += ai[j + 1] * x[j + 1];
+                    s2 += ai[j + 2] * x[j + 2]; s3 += ai[j + 3] * x[j + 3];
+                }
+                for (; j < A.columns; ++j) {
+                    s0 += ai[j] * x[j];
+                }
+                y[i] += alpha * ((s0 + s1) + (s2 + s3));
+            }
+        } else {
+            // column-major: y += x_j * (column j) for every j
+            for (size_t j = 0; j < A.columns; ++j) {
+                const T xj = alpha * x[j];
+                const T* aj = &A(0, j);
+                for (size_t i = i0; i < i1; ++i) {
+                    y[i] += xj * aj[i * A.rowStride];
+                }
+            }
+        }
+    });
+}
+
+/**
+ * Solves A X = B in place of B for triangular A (lower or upper, optionally with implicit unit diagonal).
+ *
+ * Diagonal blocks of trsmBlockSize rows are solved by substitution, the remaining rows of B are then updated
+ * with gemm (or gemv, when B is a single contiguous column), which is where the work is parallelized.
+ */
+template <typename Policy, typename T>
+void trsm(Policy policy, bool lower, bool unitDiagonal, StridedMatrix<const T> A, StridedMatrix<T> B) {
+    const size_t n = A.rows;
+    const bool vector = B.columns == 1 && B.rowStride == 1;
+    const auto substitute = [&](size_t i0, size_t i1) {
+        for (size_t step = 0; step < i1 - i0; ++step) {
+            const size_t i = lower ? i0 + step : i1 - 1 - step;
+            const size_t k0 = lower ? i0 : i + 1, k1 = lower ? i : i1;
+            for (size_t k = k0; k < k1; ++k) {
+                const T a = A(i, k);
+                for (size_t j = 0; j < B.columns; ++j) {
+                    B(i, j) -= a * B(k, j);
+                }
+            }
+            if (!unitDiagonal) {
+                const T diagonal = A(i, i);
+                for (size_t j = 0; j < B.columns; ++j) {
+                    B(i, j) /= diagonal;
+                }
+            }
+        }
+    };
+    const auto update = [&](size_t rows0, size_t rows1, size_t i0, size_t i1) {
+        // B[rows0, rows1) -= A[rows0, rows1) x [i0, i1) * B[i0, i1)
+        if (rows0 == rows1) {
+            return;
+        }
+        const StridedMatrix<const T> Ablock = A.block(rows0, i0, rows1 - rows0, i1 - i0);
+        if (vector) {
+            gemv(policy, T(-1), Ablock, &B(i0, 0), &B(rows0, 0));
+        } else {
+            const StridedMatrix<const T> solved { &B(i0, 0), i1 - i0, B.columns, B.rowStride, B.columnStride };
+            gemm(policy, T(-1), Ablock, solved, B.block(rows0, 0, rows1 - rows0, B.columns));
+        }
+    };
+    if (lower) {
+        for (size_t i0 = 0; i0 < n; i0 += trsmBlockSize) {
+            const size_t i1 = std::min(i0 + trsmBlockSize, n);
+            substitute(i0, i1);
+            update(i1, n, i0, i1);
+        }
+    } else {
+        for (size_t i1 = n; i1 > 0;) {
+            const size_t i0 = i1 > trsmBlockSize ? i1 - trsmBlockSize : 0;
+            substitute(i0, i1);
+            update(0, i0, i0, i1);
+            i1 = i0;
+        }
+    }
+}
+
+template <typename T>
+StridedMatrix<T> columnVector(std::vector<T>& v) noexcept {
+    return { v.data(), v.size(), 1, 1, v.size() };
+}
+
+/**
+ * Side of square tiles transposed by a single task, and of register blocks within them. Tiles are transposed
+ * into a buffer in cache and written out as whole rows: long contiguous runs on both sides matter more for
+ * memory bandwidth than keeping a tile in L1.
+ */
+constexpr size_t transposeTile = 256;
+constexpr size_t transposeKernel = 8;
+
+/**
+ * out(j, i) = in(i, j) for a transposeKernel x transposeKernel block with contiguous rows. The block goes through
+ * a local array, so both loads and stores are contiguous rows, and the compiler turns it into register shuffles.
+ */
+template <typename T>
+inline void transposeKernelBlock(const T* in, size_t inStride, T* out, size_t outStride) noexcept {
+    T block[transposeKernel][transposeKernel];
+    for (size_t i = 0; i < transposeKernel; ++i) {
+        for (size_t j = 0; j < transposeKernel; ++j) {
+            block[j][i] = in[i * inStride + j];
+        }
+    }
+    for (size_t j = 0; j < transposeKernel; ++j) {
+        for (size_t i = 0; i < transposeKernel; ++i) {
+            out[j * outStride + i] = block[j][i];
+        }
+    }
+}
+
+/**
+ * out(j, i) = in(i, j) for a rows x columns block with contiguous rows (out must not overlap with in).
+ */
+template <typename T>
+void transposeBlock(const T* in, size_t inStride, T* out, size_t outStride, size_t rows, size_t columns) noexcept {
+    const size_t fullRows = rows / transposeKernel * transposeKernel;
+    const size_t fullColumns = columns / transposeKernel * transposeKernel;
+    for (size_t i = 0; i < fullRows; i += transposeKernel) {
+        for (size_t j = 0; j < fullColumns; j += transposeKernel) {
+            transposeKernelBlock(in + i * inStride + j, inStride, out + j * outStride + i, outStride);
+        }
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = i < fullRows ? fullColumns : 0; j < columns; ++j) {
+            out[j * outStride + i] = in[i * inStride + j];
+        }
+    }
+}
+
+/**
+ * B = A^T, i.e. B(j, i) = A(i, j); B must not overlap with A.
+ *
+ * Tiles of transposeTile x transposeTile are processed independently (in parallel, if requested). When rows
+ * (or columns) of both A and B are contiguous, tiles are transposed with transposeKernelBlock into a buffer,
+ * which is then copied into B row by row; when storage orders differ, the transpose is a copy of contiguous rows.
+ */
+template <typename Policy, typename T>
+void transpose(Policy policy, StridedMatrix<const T> A, StridedMatrix<T> B) {
+    if (A.columnStride != 1 && A.rowStride == 1) {
+        // B^T = (A^T)^T, rows of A^T are contiguous
+        std::swap(A.rows, A.columns);
+        std::swap(A.rowStride, A.columnStride);
+        std::swap(B.rows, B.columns);
+        std::swap(B.rowStride, B.columnStride);
+    }
+    const size_t rowTiles = (A.rows + transposeTile - 1) / transposeTile;
+    const size_t columnTiles = (A.columns + transposeTile - 1) / transposeTile;
+    forEachIndex(policy, rowTiles * columnTiles, [&](size_t tile) {
+        const size_t i0 = tile / columnTiles * transposeTile, j0 = tile % columnTiles * transposeTile;
+        const size_t rows = std::min(transposeTile, A.rows - i0), columns = std::min(transposeTile, A.columns - j0);
+        if (A.columnStride == 1 && B.columnStride == 1) {
+            ArenaScope scope;
+            T* buffer = scope.allocate<T>(rows * columns);
+            transposeBlock(&A(i0, j0), A.rowStride, buffer, rows, rows, columns);
+            for (size_t j = 0; j < columns; ++j) {
+                std::copy_n(buffer + j * rows, rows, &B(j0 + j, i0));
+            }
+        } else if (A.columnStride == 1 && B.rowStride == 1) {
+            for (size_t i = i0; i < i0 + rows; ++i) {
+                std::copy_n(&A(i, j0), columns, &B(j0, i));
+            }
+        } else {
+            for (size_t i = i0; i < i0 + rows; ++i) {
+                for (size_t j = j0; j < j0 + columns; ++j) {
+                    B(j, i) = A(i, j);
+                }
+            }
+        }
+    });
+}
+
+/**
+ * A = A^T for square A with contiguous rows (or columns).
+ *
+ * Tiles above the diagonal are swapped with their mirror images below it through local buffers, diagonal tiles
+ * are transposed through one buffer; every pair of tiles is an independent task.
+ */
+template <typename Policy, typename T>
+void transposeInPlace(Policy policy, StridedMatrix<T> A) {
+    if (A.columnStride != 1) {
+        A = A.transposed();
+    }
+    const size_t tiles = (A.rows + transposeTile - 1) / transposeTile;
+    forEachIndex(policy, tiles * (tiles + 1) / 2, [&](size_t pair) {
+        // pair enumerates (I, J) with I <= J row by row
+        size_t I = 0;
+        while (pair >= tiles - I) {
+            pair -= tiles - I;
+            ++I;
+        }
+        const size_t J = I + pair;
+        const size_t i0 = I * transposeTile, j0 = J * transposeTile;
+        const size_t rows = std::min(transposeTile, A.rows - i0), columns = std::min(transposeTile, A.rows - j0);
+        ArenaScope scope;
+        T* upper = scope.allocate<T>(rows * columns);
+        transposeBlock(&A(i0, j0), A.rowStride, upper, rows, rows, columns);
+        if (I != J) {
+            T* lower = scope.allocate<T>(rows * columns);
+            transposeBlock(&A(j0, i0), A.rowStride, lower, columns, columns, rows);
+            for (size_t i = 0; i < rows; ++i) {
+                std::copy_n(lower + i * columns, columns, &A(i0 + i, j0));
+            }
+        }
+        for (size_t j = 0; j < columns; ++j) {
+            std::copy_n(upper + j * rows, rows, &A(j0 + j, i0));
+        }
+    });
+}
+
+} // detail
+
+/**
+ * Computes matrix product A * B.
+ * @tparam Policy - execution policy type (usually deduced).
+ * @param policy - execution policy; with parallel ones, tiles of the result are computed on the thread pool.
+ * @return product as row-major Surface.
+ */
+template <
+    typename Policy, typename T, bool rowMajorA, bool rowMajorB, typename AllocA, typename AllocB,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+Surface<T> multiply(Policy policy, const Surface<T, rowMajorA, AllocA>& A, const Surface<T, rowMajorB, AllocB>& B) {
+    if (A.sizeY() != B.sizeX()) {
+        throw std::invalid_argument("multiply: inner dimensions do not match");
+    }
+    Surface<T> C (A.sizeX(), B.sizeY());
+    detail::gemm(policy, T(1), detail::stridedMatrix(A), detail::stridedMatrix(B), detail::stridedMatrix(C));
+    return C;
+}
+
+/**
+ * Computes matrix product A * B sequentially.
+ */
+template <typename T, bool rowMajorA, bool rowMajorB, typename AllocA, typename AllocB>
+Surface<T> multiply(const Surface<T, rowMajorA, AllocA>& A, const Surface<T, rowMajorB, AllocB>& B) {
+    return multiply(execution::seq, A, B);
+}
+
+/**
+ * Computes matrix-vector product A * x.
+ * @tparam Policy - execution policy type (usually deduced).
+ * @param policy - execution policy; with parallel ones, blocks of rows are processed on the thread pool.
+ */
+template <
+    typename Policy, typename T, bool rowMajor, typename Alloc,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+std::vector<T> multiply(Policy policy, const Surface<T, rowMajor, Alloc>& A, const std::vector<T>& x) {
+    if (A.sizeY() != x.size()) {
+        throw std::invalid_argument("multiply: matrix and vector sizes do not match");
+    }
+    std::vector<T> y (A.sizeX());
+    detail::gemv(policy, T(1), detail::stridedMatrix(A), x.data(), y.data());
+    return y;
+}
+
+/**
+ * Computes matrix-vector product A * x sequentially.
+ */
+template <typename T, bool rowMajor, typename Alloc>
+std::vector<T> multiply(const Surface<T, rowMajor, Alloc>& A, const std::vector<T>& x) {
+    return multiply(execution::seq, A, x);
+}
+
+/**
+ * Computes transposed matrix A^T, stored in the same order as A.
+ * @param policy - execution policy; with parallel ones, tiles are transposed on the thread pool.
+ */
+template <
+    typename Policy, typename T, bool rowMajor, typename Alloc,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+Surface<T, rowMajor, Alloc> transpose(Policy policy, const Surface<T, rowMajor, Alloc>& A) {
+    Surface<T, rowMajor, Alloc> result (A.sizeY(), A.sizeX(), A.get_allocator());
+    detail::transpose(policy, detail::stridedMatrix(A), detail::stridedMatrix(result));
+    return result;
+}
+
+/**
+ * Computes transposed matrix A^T sequentially.
+ */
+template <typename T, bool rowMajor, typename Alloc>
+Surface<T, rowMajor, Alloc> transpose(const Surface<T, rowMajor, Alloc>& A) {
+    return transpose(execution::seq, A);
+}
+
+/**
+ * Transposes square matrix in place.
+ * @param policy - execution policy; with parallel ones, pairs of tiles are swapped on the thread pool.
+ * @throws std::invalid_argument if A is not square.
+ */
+template <
+    typename Policy, typename T, bool rowMajor, typename Alloc,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+void transposeInPlace(Policy policy, Surface<T, rowMajor, Alloc>& A) {
+    if (A.sizeX() != A.sizeY()) {
+        throw std::invalid_argument("transposeInPlace: matrix is not square");
+    }
+    detail::transposeInPlace(policy, detail::stridedMatrix(A));
+}
+
+/**
+ * Transposes square matrix in place sequentially.
+ */
+template <typename T, bool rowMajor, typename Alloc>
+void transposeInPlace(Surface<T, rowMajor, Alloc>& A) {
+    transposeInPlace(execution::seq, A);
+}
+
+/**
+ * Copies A into surface with given storage order: result.at(x, y) == A.at(x, y).
+ *
+ * Changing the storage order is a transpose of the underlying storage, which is done tile by tile, so it
+ * stays cache friendly for large matrices (unlike copying through at()). Padding of A is not preserved.
+ * @tparam rowMajorResult - storage order of the result.
+ * @param policy - execution policy; with parallel ones, tiles are converted on the thread pool.
+ */
+template <
+    bool rowMajorResult, typename Policy, typename T, bool rowMajor, typename Alloc,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+Surface<T, rowMajorResult, Alloc> convertLayout(Policy policy, const Surface<T, rowMajor, Alloc>& A) {
+    Surface<T, rowMajorResult, Alloc> result (A.sizeX(), A.sizeY(), A.get_allocator());
+    // result^T = A^T: storage of A is transposed into storage of result
+    detail::transpose(policy, detail::stridedMatrix(A), detail::stridedMatrix(result).transposed());
+    return result;
+}
+
+/**
+ * Copies A into surface with given storage order sequentially.
+ */
+template <bool rowMajorResult, typename T, bool rowMajor, typename Alloc>
+Surface<T, rowMajorResult, Alloc> convertLayout(const Surface<T, rowMajor, Alloc>& A) {
+    return convertLayout<rowMajorResult>(execution::seq, A);
+}
+
+/**
+ * Kind of triangular matrix, passed to triangular solvers.
+ */
+enum class Triangle {
+    Lower,     ///< lower triangular
+    UnitLower, ///< lower triangular with unit diagonal (diagonal elements are not accessed)
+    Upper,     ///< upper triangular
+    UnitUpper  ///< upper triangular with unit diagonal (diagonal elements are not accessed)
+};
+
+/**
+ * Solves A X = B in place of B, where A is triangular. Elements of A outside of the triangle are not accessed.
+ * @param policy - execution policy.
+ * @param triangle - which triangle of A to use.
+ * @param A - square matrix.
+ * @param B - right-hand sides (columns), overwritten by solutions.
+ */
+template <
+    typename Policy, typename T, bool rowMajorA, bool rowMajorB, typename AllocA, typename AllocB,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+void solveTriangular(Policy policy, Triangle triangle,
+                     const Surface<T, rowMajorA, AllocA>& A, Surface<T, rowMajorB, AllocB>& B) {
+    if (A.sizeX() != A.sizeY() || A.sizeX() != B.sizeX()) {
+        throw std::invalid_argument("solveTriangular: matrix sizes do not match");
+    }
+    detail::trsm(policy, triangle == Triangle::Lower || triangle == Triangle::UnitLower,
+                 triangle == Triangle::UnitLower || triangle == Triangle::UnitUpper,
+                 detail::stridedMatrix(A), detail::stridedMatrix(B));
+}
+
+/**
+ * Solves A x = b, where A is triangular.
+ * @return solution x.
+ */
+template <
+    typename Policy, typename T, bool rowMajor, typename Alloc,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+std::vector<T> solveTriangular(Policy policy, Triangle triangle,
+                               const Surface<T, rowMajor, Alloc>& A, std::vector<T> b) {
+    if (A.sizeX() != A.sizeY() || A.sizeX() != b.size()) {
+        throw std::invalid_argument("solveTriangular: matrix and vector sizes do not match");
+    }
+    detail::trsm(policy, triangle == Triangle::Lower || triangle == Triangle::UnitLower,
+                 triangle == Triangle::UnitLower || triangle == Triangle::UnitUpper,
+                 detail::stridedMatrix(A), detail::columnVector(b));
+    return b;
+}
+
+/**
+ * Solves A x = b sequentially, where A is triangular.
+ */
+template <typename T, bool rowMajor, typename Alloc>
+std::vector<T> solveTriangular(Triangle triangle, const Surface<T, rowMajor, Alloc>& A, std::vector<T> b) {
+    return solveTriangular(execution::seq, triangle, A, std::move(b));
+}
+
+/**
+ * LU factorization with partial pivoting: P A = L U, with unit lower triangular L.
+ *
+ * Factorization is blocked and right-looking: a panel of blockSize columns is factored, then the rest of the
+ * panel rows is solved with trsm, and the trailing submatrix is updated with a single rank-blockSize gemm
+ * (parallel, if requested). Once computed, the factorization can be reused to solve for any number of
+ * right-hand sides.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+class LUFactorization {
+    Surface<T> lu_;
+    std::vector<size_t> pivots_;
+
+public:
+    /**
+     * Number of columns factored at once.
+     */
+    static constexpr size_t blockSize = 64;
+
+    /**
+     * Factors square matrix A.
+     * @param policy - execution policy used for the trailing submatrix updates.
+     * @throws std::invalid_argument if A is not square.
+     * @throws std::runtime_error if A is singular.
+     */
+    template <typename Policy, typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>>
+    LUFactorization(Policy policy, Surface<T> A) : lu_(std::move(A)), pivots_(lu_.rowCount()) {
+        if (lu_.rowCount() != lu_.columnCount()) {
+            throw std::invalid_argument("LU factorization requires square matrix");
+        }
+        const size_t n = size();
+        const auto M = detail::stridedMatrix(lu_);
+        for (size_t k0 = 0; k0 < n; k0 += blockSize) {
+            const size_t k1 = std::min(k0 + blockSize, n);
+            factorPanel(k0, k1);
+            if (k1 < n) {
+                detail::trsm<Policy, T>(policy, true, true, M.block(k0, k0, k1 - k0, k1 - k0),
+                                        M.block(k0, k1, k1 - k0, n - k1));
+                detail::gemm<Policy, T>(policy, -1, M.block(k1, k0, n - k1, k1 - k0),
+                                        M.block(k0, k1, k1 - k0, n - k1), M.block(k1, k1, n - k1, n - k1));
+            }
+        }
+    }
+
+    /**
+     * Factors square matrix A sequentially.
+     */
+    explicit LUFactorization(Surface<T> A) : LUFactorization(execution::seq, std::move(A)) {
+    }
+
+    /**
+     * @brief Returns dimension of factored matrix.
+     */
+    inline size_t size() const noexcept {
+        return lu_.rowCount();
+    }
+
+    /**
+     * @brief Returns L and U packed into one matrix (unit diagonal of L is not stored).
+     */
+    inline const Surface<T>& packed() const noexcept {
+        return lu_;
+    }
+
+    /**
+     * @brief Returns row pivots: at step k, row k was swapped with row pivots()[k].
+     */
+    inline const std::vector<size_t>& pivots() const noexcept {
+        return pivots_;
+    }
+
+    /**
+     * @brief Returns determinant of factored matrix.
+     */
+    T determinant() const noexcept {
+        T det = 1;
+        for (size_t k = 0; k < size(); ++k) {
+            det *= pivots_[k] == k ? lu_.at(k, k) : -lu_.at(k, k);
+        }
+        return det;
+    }
+
+    /**
+     * Solves A x = b.
+     */
+    template <typename Policy, typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>>
+    std::vector<T> solve(Policy policy, std::vector<T> b) const {
+        permute(detail::columnVector(b));
+        const auto M = detail::stridedMatrix(lu_);
+        detail::trsm<Policy, T>(policy, true, true, M, detail::columnVector(b));
+        detail::trsm<Policy, T>(policy, false, false, M, detail::columnVector(b));
+        return b;
+    }
+
+    std::vector<T> solve(std::vector<T> b) const {
+        return solve(execution::seq, std::move(b));
+    }
+
+    /**
+     * Solves A X = B for every column of B (size() x m).
+     */
+    template <
+        typename Policy, bool rowMajor, typename Alloc,
+        typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+    >
+    Surface<T, rowMajor, Alloc> solve(Policy policy, Surface<T, rowMajor, Alloc> B) const {
+        solveInPlace(policy, B);
+        return B;
+    }
+
+    template <bool rowMajor, typename Alloc>
+    Surface<T, rowMajor, Alloc> solve(Surface<T, rowMajor, Alloc> B) const {
+        return solve(execution::seq, std::move(B));
+    }
+
+    /**
+     * Solves A X = B for every column of B (size() x m), overwriting B with X.
+     */
+    template <
+        typename Policy, bool rowMajor, typename Alloc,
+        typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+    >
+    void solveInPlace(Policy policy, Surface<T, rowMajor, Alloc>& B) const {
+        if (B.sizeX() != size()) {
+            throw std::invalid_argument("LU solve: right-hand side size does not match");
+        }
+        permute(detail::stridedMatrix(B));
+        const auto M = detail::stridedMatrix(lu_);
+        detail::trsm<Policy, T>(policy, true, true, M, detail::stridedMatrix(B));
+        detail::trsm<Policy, T>(policy, false, false, M, detail::stridedMatrix(B));
+    }
+
+    template <bool rowMajor, typename Alloc>
+    void solveInPlace(Surface<T, rowMajor, Alloc>& B) const {
+        solveInPlace(execution::seq, B);
+    }
+
+private:
+    inline T* row(size_t i) noexcept {
+        return &lu_.at(i, 0);
+    }
+
+    void permute(detail::StridedMatrix<T> B) const noexcept {
+        for (size_t k = 0; k < size(); ++k) {
+            if (pivots_[k] != k) {
+                for (size_t j = 0; j < B.columns; ++j) {
+                    std::swap(B(k, j), B(pivots_[k], j));
+                }
+            }
+        }
+    }
+
+    /**
+     * Unblocked factorization of columns [k0, k1), rows [k0, n). Row swaps are applied to whole rows.
+     */
+    void factorPanel(size_t k0, size_t k1) {
+        const size_t n = size();
+        for (size_t k = k0; k < k1; ++k) {
+            size_t pivot = k;
+            T maxEl = std::abs(lu_.at(k, k));
+            for (size_t i = k + 1; i < n; ++i) {
+                const T el = std::abs(lu_.at(i, k));
+                if (el > maxEl) {
+                    maxEl = el; pivot = i;
+                }
+            }
+            if (maxEl == 0) {
+                throw std::runtime_error("LU factorization: matrix is singular");
+            }
+            pivots_[k] = pivot;
+            if (pivot != k) {
+                std::swap_ranges(row(k), row(k) + n, row(pivot));
+            }
+
+            const T* rk = row(k);
+            const T diagonal = rk[k];
+            for (size_t i = k + 1; i < n; ++i) {
+                T* ri = row(i);
+                const T l = ri[k] /= diagonal;
+                for (size_t j = k + 1; j < k1; ++j) {
+                    ri[j] -= l * rk[j];
+                }
+            }
+        }
+    }
+};
+
+/**
+ * LU factorization for mixed-precision iterative refinement: A is factored in a cheaper type Reduced, and
+ * solutions are refined in T:
+ *   x_0 = LU^-1 b,  r_k = b - A x_k (in T),  x_k+1 = x_k + LU^-1 r_k (correction in Reduced).
+ *
+ * Factorization, the O(n^3) part, runs at the speed of Reduced; every refinement step is O(n^2) and gains
+ * about -log10(cond(A) * eps(Reduced)) digits, so the accuracy of T is reached in a few steps, as long as
+ * cond(A) * eps(Reduced) << 1. If residuals stop decreasing or are not finite, A is factored in T and the
+ * system is solved directly (as LAPACK dsgesv does), so the result is never worse than that of
+ * LUFactorization<T>. The same is done at construction when A is singular only after rounding to Reduced.
+ * A copy of A in T is kept for residuals.
+ * @tparam T - floating point type of the system and the solution.
+ * @tparam Reduced - floating point type of the factorization (PrecisionTraits<T>::Reduced by default).
+ */
+template <typename T, typename Reduced = typename PrecisionTraits<T>::Reduced>
+class RefinedLUFactorization {
+    Surface<T> A_;
+    std::optional<LUFactorization<Reduced>> lu_;
+    std::optional<LUFactorization<T>> full_; // only if A is singular in Reduced
+    T norm_; // max row sum of |A|
+
+public:
+    /**
+     * Maximal number of refinement steps before falling back to factorization in T.
+     */
+    static constexpr size_t maxRefinements = 30;
+
+    /**
+     * Factors square matrix A in Reduced, or in T if it is singular in Reduced.
+     * @param policy - execution policy used for factorization and residuals.
+     * @throws std::invalid_argument if A is not square.
+     * @throws std::runtime_error if A is singular in T.
+     */
+    template <typename Policy, typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>>
+    RefinedLUFactorization(Policy policy, Surface<T> A) : A_(std::move(A)), norm_(0) {
+        try {
+            lu_.emplace(policy, reduce(A_));
+        } catch (const std::runtime_error&) {
+            full_.emplace(policy, A_);
+        }
+        for (size_t i = 0; i < size(); ++i) {
+            T sum = 0;
+            for (size_t j = 0; j < size(); ++j) {
+                sum += std::abs(A_.at(i, j));
+            }
+            norm_ = std::max(norm_, sum);
+        }
+    }
+
+    /**
+     * Factors square matrix A in Reduced sequentially.
+     */
+    explicit RefinedLUFactorization(Surface<T> A) : RefinedLUFactorization(execution::seq, std::move(A)) {
+    }
+
+    inline size_t size() const noexcept {
+        return A_.rowCount();
+    }
+
+    /**
+     * @brief Returns factorization in Reduced, or nullptr if A is singular in Reduced.
+     */
+    inline const LUFactorization<Reduced>* reduced() const noexcept {
+        return lu_ ? &*lu_ : nullptr;
+    }
+
+    /**
+     * Solves A x = b, refining the solution until |b - A x| <= sqrt(n) * eps(T) * |A| * |x| (max norms), which is
+     * the accuracy of a backward stable solver in T.
+     * @throws std::invalid_argument if size of b does not match.
+     */
+    template <typename Policy, typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>>
+    std::vector<T> solve(Policy policy, const std::vector<T>& b) const {
+        const size_t n = size();
+        if (b.size() != n) {
+            throw std::invalid_argument("LU solve: right-hand side size does not match");
+        }
+        if (full_) {
+            return full_->solve(policy, b);
+        }
+        const T tolerance = static_cast<T>(std::sqrt(double(n))) * PrecisionTraits<T>::epsilon() * norm_;
+        std::vector<T> x = correction(policy, b), r (n);
+        T previous = 0;
+        for (size_t step = 0; step < maxRefinements; ++step) {
+            r = b;
+            detail::gemv(policy, T(-1), detail::stridedMatrix(A_), x.data(), r.data());
+            const T rNorm = maxNorm(r);
+            if (!(rNorm - rNorm == 0)) {
+                break; // inf or NaN (std::isfinite is not defined for every T): overflow in Reduced
+            }
+            if (rNorm <= tolerance * maxNorm(x)) {
+                return x;
+            }
+            if (step > 0 && !(rNorm < previous)) {
+                break; // diverges: cond(A) is too large for Reduced
+            }
+            previous = rNorm;
+            const auto d = correction(policy, r);
+            for (size_t i = 0; i < n; ++i) {
+                x[i] += d[i];
+            }
+        }
+        return LUFactorization<T> { policy, A_ }.solve(policy, b);
+    }
+
+    /**
+     * Solves A x = b sequentially.
+     */
+    std::vector<T> solve(const std::vector<T>& b) const {
+        return solve(execution::seq, b);
+    }
+
+private:
+    static Surface<Reduced> reduce(const Surface<T>& A) {
+        // element by element: storage of A may be padded
+        Surface<Reduced> result (A.sizeX(), A.sizeY());
+        for (size_t i = 0; i < A.sizeX(); ++i) {
+            for (size_t j = 0; j < A.sizeY(); ++j) {
+                result.at(i, j) = static_cast<Reduced>(A.at(i, j));
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Returns max |v_i|, or NaN if any v_i is NaN.
+     */
+    static T maxNorm(const std::vector<T>& v) noexcept {
+        T result = 0;
+        for (const T vi : v) {
+            const T a = std::abs(vi);
+            if (!(a <= result)) {
+                result = a;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Returns LU^-1 r, scaling r into the range of Reduced.
+     */
+    template <typename Policy>
+    std::vector<T> correction(Policy policy, const std::vector<T>& r) const {
+        const T scale = maxNorm(r);
+        if (scale == 0) {
+            return std::vector<T>(r.size());
+        }
+        std::vector<Reduced> reduced (r.size());
+        for (size_t i = 0; i < r.size(); ++i) {
+            reduced[i] = static_cast<Reduced>(r[i] / scale);
+        }
+        reduced = lu_->solve(policy, std::move(reduced));
+        std::vector<T> result (r.size());
+        for (size_t i = 0; i < r.size(); ++i) {
+            result[i] = static_cast<T>(reduced[i]) * scale;
+        }
+        return result;
+    }
+};
+
+/**
+ * Solves A x = b with mixed-precision iterative refinement: factorization in Reduced, accuracy of T (see
+ * RefinedLUFactorization). For large dense systems in double this is nearly as fast as solving in float.
+ * @tparam Reduced - floating point type of the factorization (PrecisionTraits<T>::Reduced by default).
+ * @param policy - execution policy used for factorization and residuals.
+ * @param A - square matrix.
+ * @param b - right-hand side.
+ * @return solution.
+ */
+template <
+    typename Reduced = void, typename Policy, typename T, bool rowMajor, typename Alloc,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+std::vector<T> solveMixedPrecision(Policy policy, const Surface<T, rowMajor, Alloc>& A, const std::vector<T>& b) {
+    using Factor = std::conditional_t<std::is_void_v<Reduced>, typename PrecisionTraits<T>::Reduced, Reduced>;
+    if (A.sizeX() != A.sizeY() || A.sizeX() != b.size()) {
+        throw std::invalid_argument("solveMixedPrecision: matrix and vector sizes do not match");
+    }
+    Surface<T> dense (A.sizeX(), A.sizeY());
+    detail::transpose(policy, detail::stridedMatrix(A), detail::stridedMatrix(dense).transposed());
+    return RefinedLUFactorization<T, Factor> { policy, std::move(dense) }.solve(policy, b);
+}
+
+/**
+ * Solves A x = b with mixed-precision iterative refinement sequentially.
+ */
+template <typename Reduced = void, typename T, bool rowMajor, typename Alloc>
+std::vector<T> solveMixedPrecision(const Surface<T, rowMajor, Alloc>& A, const std::vector<T>& b) {
+    return solveMixedPrecision<Reduced>(execution::seq, A, b);
+}
+
+/**
+ * Numbers of nonzero subdiagonals (lower) and superdiagonals (upper) of a matrix.
+ */
+struct Bandwidth {
+    size_t lower;
+    size_t upper;
+};
+
+/**
+ * Square band matrix: only elements with -lower <= j - i <= upper are stored, which takes
+ * size() * (lower + upper + 1) elements instead of size()^2.
+ *
+ * Diagonals are stored row by row, so that each row of the band is contiguous.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+class BandMatrix {
+    std::vector<T> data_;
+    size_t size_;
+    size_t lower_;
+    size_t upper_;
+
+public:
+    BandMatrix(size_t size, size_t lower, size_t upper)
+        : data_(size * (lower + upper + 1)), size_(size), lower_(lower), upper_(upper) {
+    }
+
+    /**
+     * Copies band of A (square Surface of any storage order). Elements outside of the band are ignored.
+     */
+    template <bool rowMajor, typename Alloc>
+    BandMatrix(const Surface<T, rowMajor, Alloc>& A, Bandwidth band) : BandMatrix(A.sizeX(), band.lower, band.upper) {
+        copyBand(detail::stridedMatrix(A));
+    }
+
+    explicit BandMatrix(const detail::StridedMatrix<const T>& A, Bandwidth band)
+        : BandMatrix(A.rows, band.lower, band.upper) {
+        copyBand(A);
+    }
+
+    inline size_t size() const noexcept {
+        return size_;
+    }
+
+    inline Bandwidth bandwidth() const noexcept {
+        return { lower_, upper_ };
+    }
+
+    /**
+     * @brief Returns true if element (i, j) is stored.
+     */
+    inline bool contains(size_t i, size_t j) const noexcept {
+        return j + lower_ >= i && j <= i + upper_;
+    }
+
+    /**
+     * @brief NOTE: element (i, j) must be inside of the band, which is not checked!
+     */
+    inline T& at(size_t i, size_t j) noexcept {
+        return data_[i * (lower_ + upper_) + j + lower_];
+    }
+
+    /**
+     * @brief NOTE: element (i, j) must be inside of the band, which is not checked!
+     */
+    inline const T& at(size_t i, size_t j) const noexcept {
+        return data_[i * (lower_ + upper_) + j + lower_];
+    }
+
+private:
+    void copyBand(const detail::StridedMatrix<const T>& A) noexcept {
+        for (size_t i = 0; i < size_; ++i) {
+            const size_t j0 = i > lower_ ? i - lower_ : 0, j1 = std::min(size_, i + upper_ + 1);
+            for (size_t j = j0; j < j1; ++j) {
+                at(i, j) = A(i, j);
+            }
+        }
+    }
+};
+
+/**
+ * LU factorization with partial pivoting of a band matrix, in O(size * lower * (lower + upper)) operations.
+ *
+ * Row swaps make U wider than A: it has up to lower + upper superdiagonals, for which storage is reserved.
+ * Multipliers of L are kept in place and applied interleaved with the swaps when solving (as in LAPACK gbtrf).
+ * @tparam T - floating point type.
+ */
+template <typename T>
+class BandLUFactorization {
+    BandMatrix<T> lu_;
+    std::vector<size_t> pivots_;
+    size_t lower_;
+
+public:
+    /**
+     * Factors band matrix A.
+     * @throws std::runtime_error if A is singular.
+     */
+    explicit BandLUFactorization(const BandMatrix<T>& A)
+        : lu_(A.size(), A.bandwidth().lower, A.bandwidth().lower + A.bandwidth().upper),
+          pivots_(A.size()), lower_(A.bandwidth().lower) {
+        const size_t n = size(), width = lu_.bandwidth().upper;
+        for (size_t i = 0; i < n; ++i) {
+            const size_t j0 = i > lower_ ? i - lower_ : 0, j1 = std::min(n, i + A.bandwidth().upper + 1);
+            for (size_t j = j0; j < j1; ++j) {
+                lu_.at(i, j) = A.at(i, j);
+            }
+        }
+
+        for (size_t k = 0; k < n; ++k) {
+            const size_t rows = std::min(n, k + lower_ + 1), columns = std::min(n, k + width + 1);
+            size_t pivot = k;
+            T maxEl = std::abs(lu_.at(k, k));
+            for (size_t i = k + 1; i < rows; ++i) {
+                const T el = std::abs(lu_.at(i, k));
+                if (el > maxEl) {
+                    maxEl = el; pivot = i;
+                }
+            }
+            if (maxEl == 0) {
+                throw std::runtime_error("band LU factorization: matrix is singular");
+            }
+            pivots_[k] = pivot;
+            if (pivot != k) {
+                std::swap_ranges(&lu_.at(k, k), &lu_.at(k, k) + (columns - k), &lu_.at(pivot, k));
+            }
+
+            const T* rk = &lu_.at(k, 0);
+            const T diagonal = lu_.at(k, k);
+            for (size_t i = k + 1; i < rows; ++i) {
+                T* ri = &lu_.at(i, 0); // rows share indexing, so that ri[j] and rk[j] are elements of column j
+                const T l = ri[k] /= diagonal;
+                for (size_t j = k + 1; j < columns; ++j) {
+                    ri[j] -= l * rk[j];
+                }
+            }
+        }
+    }
+
+    inline size_t size() const noexcept {
+        return lu_.size();
+    }
+
+    /**
+     * Solves A x = b.
+     */
+    std::vector<T> solve(std::vector<T> b) const {
+        if (b.size() != size()) {
+            throw std::invalid_argument("band LU solve: right-hand side size does not match");
+        }
+        const size_t n = size(), width = lu_.bandwidth().upper;
+        for (size_t k = 0; k < n; ++k) {
+            std::swap(b[k], b[pivots_[k]]);
+            const size_t rows = std::min(n, k + lower_ + 1);
+            for (size_t i = k + 1; i < rows; ++i) {
+                b[i] -= lu_.at(i, k) * b[k];
+            }
+        }
+        for (size_t i = n; i-- > 0;) {
+            const size_t columns = std::min(n, i + width + 1);
+            T sum = b[i];
+            for (size_t j = i + 1; j < columns; ++j) {
+                sum -= lu_.at(i, j) * b[j];
+            }
+            b[i] = sum / lu_.at(i, i);
+        }
+        return b;
+    }
+};
+
+/**
+ * Solves tridiagonal system with Thomas algorithm in O(n) operations.
+ *
+ * There is no pivoting, so the matrix should be diagonally dominant (or otherwise known to be safe, e.g. symmetric
+ * positive definite); BandLUFactorization handles the general case.
+ * @param sub - subdiagonal, n - 1 elements (sub[i] is in row i + 1).
+ * @param diagonal - diagonal, n elements.
+ * @param super - superdiagonal, n - 1 elements (super[i] is in row i).
+ * @param rhs - right-hand side, n elements.
+ * @return solution.
+ * @throws std::runtime_error if zero pivot is encountered.
+ */
+template <typename T>
+std::vector<T> solveTridiagonal(const std::vector<T>& sub, const std::vector<T>& diagonal,
+                                const std::vector<T>& super, std::vector<T> rhs) {
+    const size_t n = diagonal.size();
+    if (rhs.size() != n || (n > 0 && (sub.size() != n - 1 || super.size() != n - 1))) {
+        throw std::invalid_argument("solveTridiagonal: sizes of diagonals do not match");
+    }
+    if (n == 0) {
+        return rhs;
+    }
+    std::vector<T> c (n);
+    T pivot = diagonal[0];
+    for (size_t i = 0;; ++i) {
+        if (pivot == 0) {
+            throw std::runtime_error("solveTridiagonal: zero pivot");
+        }
+        rhs[i] /= pivot;
+        if (i + 1 == n) {
+            break;
+        }
+        c[i] = super[i] / pivot;
+        pivot = diagonal[i + 1] - sub[i] * c[i];
+        rhs[i + 1] -= sub[i] * rhs[i];
+    }
+    for (size_t i = n - 1; i-- > 0;) {
+        rhs[i] -= c[i] * rhs[i + 1];
+    }
+    return rhs;
+}
+
+namespace detail {
+
+template <typename T>
+Bandwidth bandwidth(const StridedMatrix<const T>& A) noexcept {
+    Bandwidth band { 0, 0 };
+    for (size_t i = 0; i < A.rows; ++i) {
+        for (size_t j = 0; j < A.columns; ++j) {
+            if (A(i, j) != 0) {
+                band.lower = std::max(band.lower, i > j ? i - j : 0);
+                band.upper = std::max(band.upper, j > i ? j - i : 0);
+            }
+        }
+    }
+    return band;
+}
+
+/**
+ * Band solver is used when the band is at most this fraction of the matrix (as 1 / bandFraction);
+ * wider bands are faster to solve with blocked dense LU.
+ */
+constexpr size_t bandFraction = 8;
+
+template <typename Policy, typename T>
+std::vector<T> solveLinearSystem(Policy policy, const StridedMatrix<const T>& A, std::vector<T> b) {
+    const size_t n = A.rows;
+    const Bandwidth band = bandwidth(A);
+    if (band.lower <= 1 && band.upper <= 1 && n > 1) {
+        std::vector<T> sub (n - 1), diagonal (n), super (n - 1);
+        bool dominant = true;
+        for (size_t i = 0; i < n; ++i) {
+            diagonal[i] = A(i, i);
+            T offDiagonal = 0;
+            if (i > 0) {
+                offDiagonal += std::abs(sub[i - 1] = A(i, i - 1));
+            }
+            if (i + 1 < n) {
+                offDiagonal += std::abs(super[i] = A(i, i + 1));
+            }
+            dominant = dominant && std::abs(diagonal[i]) >= offDiagonal;
+        }
+        if (dominant) {
+            return solveTridiagonal(sub, diagonal, super, std::move(b));
+        }
+    }
+    if ((band.lower + band.upper + 1) * bandFraction <= n) {
+        return BandLUFactorization<T> { BandMatrix<T> { A, band } }.solve(std::move(b));
+    }
+    Surface<T> dense (n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            dense.at(i, j) = A(i, j);
+        }
+    }
+    return LUFactorization<T> { policy, std::move(dense) }.solve(policy, std::move(b));
+}
+
+} // detail
+
+/**
+ * Detects bandwidth of a square matrix: the farthest from the diagonal nonzero elements below and above it.
+ */
+template <typename T, bool rowMajor, typename Alloc>
+Bandwidth bandwidth(const Surface<T, rowMajor, Alloc>& A) noexcept {
+    return detail::bandwidth(detail::stridedMatrix(A));
+}
+
+/**
+ * Solves A x = b, choosing solver by structure of A.
+ *
+ * Tridiagonal diagonally dominant matrices are solved with Thomas algorithm, matrices with narrow band are
+ * copied into band storage and solved with BandLUFactorization, others are solved with (blocked, parallel if
+ * requested) LUFactorization.
+ * @param policy - execution policy used by the dense solver.
+ * @param A - square matrix.
+ * @param b - right-hand side.
+ * @return solution.
+ */
+template <
+    typename Policy, typename T, bool rowMajor, typename Alloc,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+std::vector<T> solveLinearSystem(Policy policy, const Surface<T, rowMajor, Alloc>& A, std::vector<T> b) {
+    if (A.sizeX() != A.sizeY() || A.sizeX() != b.size()) {
+        throw std::invalid_argument("solveLinearSystem: matrix and vector sizes do not match");
+    }
+    return detail::solveLinearSystem(policy, detail::stridedMatrix(A), std::move(b));
+}
+
+/**
+ * Solves A x = b, choosing solver by structure of A (dense solver is sequential).
+ */
+template <typename T, bool rowMajor, typename Alloc>
+std::vector<T> solveLinearSystem(const Surface<T, rowMajor, Alloc>& A, std::vector<T> b) {
+    return solveLinearSystem(execution::seq, A, std::move(b));
+}
+
+} // nya
+
+#endif //NUMUTILS_LINEARALGEBRA_HPP
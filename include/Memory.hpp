@@ -0,0 +1,250 @@
+#ifndef NUMUTILS_MEMORY_HPP
+#define NUMUTILS_MEMORY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace nya {
+
+/**
+ * Size of cache line (and of the widest SIMD register) of common targets, in bytes.
+ */
+constexpr size_t cacheLineSize = 64;
+
+/**
+ * Allocator of memory aligned to given boundary (cache line by default), e.g. for rows loaded with SIMD
+ * instructions.
+ * @tparam T - type of elements.
+ * @tparam alignment - alignment in bytes (power of two).
+ */
+template <typename T, size_t alignment = cacheLineSize>
+struct AlignedAllocator {
+    static_assert(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment should be a power of two");
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, alignment>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(std::max(alignment, alignof(T)))));
+    }
+
+    void deallocate(T* p, size_t) noexcept {
+        ::operator delete(p, std::align_val_t(std::max(alignment, alignof(T))));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, alignment>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, alignment>&) const noexcept {
+        return false;
+    }
+};
+
+/**
+ * Monotonic (bump pointer) memory arena for short-lived buffers.
+ *
+ * Allocation is a pointer increment, deallocation of separate buffers is a no-op; instead, all memory allocated
+ * after mark() is reclaimed at once by release() (see ArenaScope). Memory blocks are kept for reuse, so code
+ * which repeatedly allocates the same temporaries (e.g. tiles of gemm, tables of Galerkin assembly) stops
+ * allocating from the heap after the first run. Every allocation is aligned to cache line.
+ *
+ * Arena is not thread-safe; Arena::local() gives an arena per thread.
+ */
+class Arena {
+    struct BlockDeleter {
+        void operator()(std::byte* p) const noexcept {
+            ::operator delete(p, std::align_val_t(cacheLineSize));
+        }
+    };
+
+    struct Block {
+        std::unique_ptr<std::byte, BlockDeleter> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    size_t blockSize_;
+    size_t current_ = 0;
+    size_t offset_ = 0;
+
+public:
+    /**
+     * Position of an arena, to which it can be rewound.
+     */
+    struct Marker {
+        size_t block;
+        size_t offset;
+    };
+
+    static constexpr size_t defaultBlockSize = 1 << 20;
+
+    /**
+     * @param blockSize - minimal size of memory blocks requested from the heap.
+     */
+    explicit Arena(size_t blockSize = defaultBlockSize) : blockSize_(blockSize) {
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Returns arena of the calling thread.
+     */
+    static Arena& local() {
+        thread_local Arena arena;
+        return arena;
+    }
+
+    /**
+     * Allocates bytes aligned to alignment (at least to cache line).
+     */
+    void* allocate(size_t bytes, size_t alignment = cacheLineSize) {
+        alignment = std::max(alignment, cacheLineSize);
+        for (; current_ < blocks_.size(); ++current_, offset_ = 0) {
+            if (void* p = allocateIn(blocks_[current_], bytes, alignment)) {
+                return p;
+            }
+        }
+        // blocks are aligned to cache line, larger alignment may need extra space
+        const size_t size = std::max(blockSize_, bytes + alignment - cacheLineSize);
+        auto* data = static_cast<std::byte*>(::operator new(size, std::align_val_t(cacheLineSize)));
+        blocks_.push_back({ std::unique_ptr<std::byte, BlockDeleter> { data }, size });
+        return allocateIn(blocks_[current_], bytes, alignment);
+    }
+
+    /**
+     * Allocates uninitialized array of count values of T (trivially destructible).
+     */
+    template <typename T>
+    T* allocate(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena never calls destructors");
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    inline Marker mark() const noexcept {
+        return { current_, offset_ };
+    }
+
+    /**
+     * Reclaims all memory allocated after marker was taken (blocks stay reserved for future allocations).
+     */
+    inline void release(Marker marker) noexcept {
+        current_ = marker.block;
+        offset_ = marker.offset;
+    }
+
+    /**
+     * @brief Returns total size of memory blocks held by the arena.
+     */
+    size_t capacity() const noexcept {
+        size_t total = 0;
+        for (const auto& block : blocks_) {
+            total += block.size;
+        }
+        return total;
+    }
+
+private:
+    void* allocateIn(const Block& block, size_t bytes, size_t alignment) noexcept {
+        const auto base = reinterpret_cast<uintptr_t>(block.data.get());
+        const size_t start = (base + offset_ + alignment - 1) / alignment * alignment - base;
+        if (start + bytes > block.size) {
+            return nullptr;
+        }
+        offset_ = start + bytes;
+        return block.data.get() + start;
+    }
+};
+
+/**
+ * Rewinds arena to its state at construction, when the scope ends.
+ *
+ * All buffers and containers allocated from the arena within the scope must be destroyed before it.
+ */
+class ArenaScope {
+    Arena& arena_;
+    Arena::Marker marker_;
+
+public:
+    explicit ArenaScope(Arena& arena = Arena::local()) noexcept : arena_(arena), marker_(arena.mark()) {
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    ~ArenaScope() {
+        arena_.release(marker_);
+    }
+
+    inline Arena& arena() const noexcept {
+        return arena_;
+    }
+
+    template <typename T>
+    inline T* allocate(size_t count) {
+        return arena_.allocate<T>(count);
+    }
+};
+
+/**
+ * Standard allocator, which takes memory from an Arena (the calling thread's one by default).
+ *
+ * Deallocation does nothing; memory is reclaimed when the enclosing ArenaScope ends, so containers using this
+ * allocator should not outlive it. Allocations are aligned to cache line.
+ * @tparam T - type of elements.
+ */
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    Arena* arena;
+
+    ArenaAllocator() : arena(&Arena::local()) {
+    }
+
+    explicit ArenaAllocator(Arena& arena) noexcept : arena(&arena) {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {
+    }
+
+    inline T* allocate(size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    inline void deallocate(T*, size_t) noexcept {
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena == other.arena;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+        return arena != other.arena;
+    }
+};
+
+} // nya
+
+#endif //NUMUTILS_MEMORY_HPP
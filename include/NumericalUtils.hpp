@@ -1,15 +1,32 @@
 #ifndef NUMUTILS_NUMERICALUTILS_HPP
 #define NUMUTILS_NUMERICALUTILS_HPP
 
+#include <array>
+#include <memory>
 #include <numeric>
 #include <algorithm>
 #include <functional>
 #include <cmath>
 #include <tuple>
+#include <iterator>
+#include <utility>
+#include <vector>
 
+#include "AutoDiff.hpp"
+#include "Basis.hpp"
+#include "Batch.hpp"
+#include "Cubature.hpp"
+#include "LinearAlgebra.hpp"
+#include "Ode.hpp"
 #include "Surface.hpp"
+#include "SurfaceIO.hpp"
+#include "Quadrature.hpp"
+#include "Random.hpp"
 #include "Range.hpp"
+#include "Sparse.hpp"
+#include "Summation.hpp"
 #include "PrecisionTraits.hpp"
+#include "ThreadPool.hpp"
 
 #ifdef NUMERICALUTILS_DEBUG_OUTPUT
 #include <iostream>
@@ -98,32 +115,786 @@ auto power(F f, T p) {
  */
 constexpr auto dVar = std::numeric_limits<double>::quiet_NaN();
 
+namespace detail {
+
+template <size_t index, size_t var, typename A, typename X>
+inline auto substituteVar(const A& a, const X& x) {
+    if constexpr (index == var) {
+        return x;
+    } else {
+        return a;
+    }
+}
+
+template <size_t var, typename F, typename Tuple, typename X, size_t ... I>
+inline auto callWithVar(const F& f, const Tuple& args, const X& x, std::index_sequence<I...>) {
+    return f(substituteVar<I, var>(std::get<I>(args), x)...);
+}
+
+/**
+ * Binds all arguments of f except the one at index var.
+ * @return Function object of one argument, which is forwarded to f in place of var. Argument type may differ
+ * from bound argument type (e.g. be a Batch), and batch support of f is preserved.
+ */
+template <size_t var, typename F, typename ... Args>
+auto bindVar(F f, Args... x0) {
+    static_assert(var < sizeof...(Args), "Index of integration variable is out of range");
+    auto bound = [f, args = std::make_tuple(x0...)](auto x) {
+        return callWithVar<var>(f, args, x, std::index_sequence_for<Args...>{});
+    };
+    if constexpr (batchSizeOf<F> > 0) {
+        return batched<batchSizeOf<F>>(bound);
+    } else {
+        return bound;
+    }
+}
+
+/**
+ * Number of range points processed by a single task of parallel integral.
+ *
+ * Chunking depends only on range size (not on number of threads), so that partial sums are always the same and
+ * reduced in the same order, i.e. parallel results are reproducible from run to run and from machine to machine.
+ */
+constexpr size_t integralChunkSize = 1 << 14;
+
+/**
+ * Integrates already bound (single-argument) function over [first, last) points of the range.
+ *
+ * If f supports batches (see batched()), abscissas are generated and passed to stepper batchSizeOf<F> at a time,
+ * and the sum is accumulated in batch lanes; the remaining points are processed one by one.
+ * If stepper shares cell endpoints (e.g. Simpson), cells are integrated with stepper.sharedCell, so that f is
+ * evaluated once per range point, and the ends of [first, last) are corrected afterwards.
+ */
+template <template <typename> typename Accumulator, typename T, typename Stepper, typename F>
+T integrateRange(const Stepper& stepper, const F& f, Range<T> D, size_t first, size_t last) {
+    constexpr bool sharedEndpoints = HasSharedEndpoints<Stepper, T>::value;
+    const auto points = D.begin();
+    const T h = D.step();
+    const auto cell = [&](auto x) {
+        if constexpr (sharedEndpoints) {
+            return stepper.sharedCell(f, h, x);
+        } else {
+            return stepper(f, h, x);
+        }
+    };
+    Accumulator<T> acc;
+    if constexpr (sharedEndpoints) {
+        if (first < last) {
+            acc.add(stepper.endpointWeight(h) * (f(points[last]) - f(points[first])));
+        }
+    }
+    if constexpr (constexpr size_t N = batchSizeOf<F>; N > 0) {
+        Accumulator<Batch<T, N>> batchAcc;
+        for (; first + N <= last; first += N) {
+            Batch<T, N> x;
+            for (size_t lane = 0; lane < N; ++lane) {
+                x[lane] = points[first + lane];
+            }
+            batchAcc.add(asBatch<T, N>(cell(x)));
+        }
+        const auto lanes = batchAcc.result();
+        for (size_t lane = 0; lane < N; ++lane) {
+            acc.add(lanes[lane]);
+        }
+    }
+    for (; first < last; ++first) {
+        acc.add(cell(points[first]));
+    }
+    return acc.result();
+}
+
+/**
+ * Sums integrateChunk(first, last) over [0, count), split into chunks of chunkSize items if policy is
+ * parallel. Partial sums are reduced in chunk order using Accumulator.
+ */
+template <template <typename> typename Accumulator, typename T, typename Policy, typename IntegrateChunk>
+T reduceChunks(Policy, size_t count, const IntegrateChunk& integrateChunk, size_t chunkSize = integralChunkSize) {
+    if constexpr (execution::isParallelPolicy<Policy>) {
+        const size_t chunks = (count + chunkSize - 1) / chunkSize;
+        if (chunks > 1) {
+            std::vector<T> partials (chunks);
+            parallelFor(chunks, [&](size_t chunk) {
+                const size_t first = chunk * chunkSize;
+                partials[chunk] = integrateChunk(first, std::min(first + chunkSize, count));
+            });
+            Accumulator<T> acc;
+            std::for_each(partials.begin(), partials.end(), [&acc](T partial) { acc.add(partial); });
+            return acc.result();
+        }
+    }
+    return integrateChunk(0, count);
+}
+
+/**
+ * Integrates bound function over the whole range.
+ */
+template <template <typename> typename Accumulator, typename T, typename Policy, typename Stepper, typename F>
+T integrateRange(Policy policy, const Stepper& stepper, const F& f, Range<T> D) {
+    return reduceChunks<Accumulator, T>(policy, D.count(), [&](size_t first, size_t last) {
+        return integrateRange<Accumulator>(stepper, f, D, first, last);
+    });
+}
+
+/**
+ * Integrates bound function using precomputed quadrature rule.
+ */
+template <template <typename> typename Accumulator, typename T, typename Policy, typename F>
+T integrateRange(Policy policy, const F& f, const QuadratureRule<T>& rule) {
+    return reduceChunks<Accumulator, T>(policy, rule.size(), [&](size_t first, size_t last) {
+        return rule.template integrate<Accumulator>(f, first, last);
+    });
+}
+
+/**
+ * Integrates bound function over D, which is either Range or QuadratureRule.
+ */
+template <template <typename> typename Accumulator, typename T, typename Policy, typename Stepper, typename F,
+          typename Domain>
+T integrateDomain(Policy policy, const Stepper& stepper, const F& f, const Domain& D) {
+    if constexpr (std::is_same_v<Domain, QuadratureRule<T>>) {
+        return integrateRange<Accumulator, T>(policy, f, D);
+    } else {
+        return integrateRange<Accumulator, T>(policy, stepper, f, Range<T> { D });
+    }
+}
+
+} // detail
+
+/**
+ * Integrates function.
+ * @tparam Stepper - stepper to be used for computing numerical integral, e.g. Euler.
+ * @tparam var - Index of integration variable.
+ * @tparam T - floating point type to use (usually deduced).
+ * @tparam Accumulator - summation method, e.g. NaiveSum, KahanSum, NeumaierSum or PairwiseSum.
+ * @tparam Policy - execution policy type (usually deduced).
+ * @tparam F - type of function object (usually deduced).
+ * @param policy - execution policy, e.g. execution::par.
+ * @param f - function object.
+ * @return New function object, representing numerical integral of f. Its first argument is either Range<T> or
+ * QuadratureRule<T> (then Stepper is not used), the rest are values of other variables of f.
+ */
+template <
+    template <typename> typename Stepper, size_t var = 0, typename T = double,
+    template <typename> typename Accumulator = NaiveSum, typename Policy, typename F,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+auto integral(Policy policy, F f) {
+    Stepper<T> stepper;
+    return [=] (const auto& D, auto... x0) {
+        if constexpr (sizeof...(x0) == 0) {
+            return detail::integrateDomain<Accumulator, T>(policy, stepper, f, D);
+        } else {
+            return detail::integrateDomain<Accumulator, T>(policy, stepper, detail::bindVar<var>(f, x0...), D);
+        }
+    };
+}
+
 /**
  * Integrates function.
  * @tparam Stepper - stepper to be used for computing numerical integral, e.g. Euler.
  * @tparam var - Index of integration variable.
  * @tparam T - floating point type to use (usually deduced).
+ * @tparam Accumulator - summation method, e.g. NaiveSum, KahanSum, NeumaierSum or PairwiseSum.
  * @tparam F - type of function object (usually deduced).
  * @param f - function object.
  * @return New function object, representing numerical integral of f.
  */
 template <
-    template <typename> typename Stepper, size_t var = 0, typename T = double, typename F
+    template <typename> typename Stepper, size_t var = 0, typename T = double,
+    template <typename> typename Accumulator = NaiveSum, typename F
 >
 auto integral(F f) {
+    return integral<Stepper, var, T, Accumulator>(execution::seq, f);
+}
+
+namespace detail {
+
+/**
+ * Number of parameter values integrated by a single task of parallel integralSweep.
+ *
+ * It's a multiple of any batch size, so that values are grouped into batches the same way regardless of policy.
+ */
+constexpr size_t sweepChunkSize = 256;
+
+template <size_t index, size_t var, size_t param, typename A, typename X, typename P>
+inline auto substituteVars(const A& a, const X& x, const P& p) {
+    if constexpr (index == var) {
+        return x;
+    } else if constexpr (index == param) {
+        return p;
+    } else {
+        return a;
+    }
+}
+
+template <size_t var, size_t param, typename F, typename Tuple, typename X, typename P, size_t ... I>
+inline auto callWithVars(const F& f, const Tuple& args, const X& x, const P& p, std::index_sequence<I...>) {
+    return f(substituteVars<I, var, param>(std::get<I>(args), x, p)...);
+}
+
+/**
+ * Integrates f over D for every parameter value of params, adding integrals to accs.
+ *
+ * Points of D are traversed once: for every point (or cell) the stepper is applied to f with each of params.
+ */
+template <size_t var, size_t param, typename T, typename Stepper, typename F, typename Tuple, typename Domain,
+          typename P, typename Acc>
+void sweepDomain(const Stepper& stepper, const F& f, const Tuple& args, const Domain& D,
+                 const std::vector<P>& params, std::vector<Acc>& accs) {
+    const auto bound = [&f, &args](const P& p) {
+        return [&f, &args, &p](auto x) {
+            return callWithVars<var, param>(f, args, x, p, std::make_index_sequence<std::tuple_size_v<Tuple>> {});
+        };
+    };
+    if constexpr (std::is_same_v<Domain, QuadratureRule<T>>) {
+        for (size_t i = 0; i < D.size(); ++i) {
+            const T node = D.nodes()[i], weight = D.weights()[i];
+            for (size_t j = 0; j < params.size(); ++j) {
+                accs[j].add(weight * broadcastTo<P>(bound(params[j])(node)));
+            }
+        }
+    } else {
+        const Range<T> range { D };
+        const auto points = range.begin();
+        const T h = range.step();
+        if constexpr (HasSharedEndpoints<Stepper, T>::value) {
+            for (size_t j = 0; j < params.size(); ++j) {
+                const auto g = bound(params[j]);
+                accs[j].add(stepper.endpointWeight(h) * broadcastTo<P>(g(points[range.count()]) - g(points[0])));
+            }
+        }
+        for (size_t i = 0; i < range.count(); ++i) {
+            const T x = points[i];
+            for (size_t j = 0; j < params.size(); ++j) {
+                if constexpr (HasSharedEndpoints<Stepper, T>::value) {
+                    accs[j].add(broadcastTo<P>(stepper.sharedCell(bound(params[j]), h, x)));
+                } else {
+                    accs[j].add(broadcastTo<P>(stepper(bound(params[j]), h, x)));
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Integrates f over D for parameter values [values, values + count), writing integrals to out.
+ *
+ * If f supports batches (see batched()), values are grouped into batches of batchSizeOf<F>, and the remaining
+ * ones are integrated one by one.
+ */
+template <template <typename> typename Accumulator, size_t var, size_t param, typename T, typename Stepper,
+          typename F, typename Tuple, typename Domain>
+void sweepValues(const Stepper& stepper, const F& f, const Tuple& args, const Domain& D,
+                 const T* values, size_t count, T* out) {
+    constexpr size_t N = batchSizeOf<F>;
+    size_t batched = 0;
+    if constexpr (N > 0) {
+        std::vector<Batch<T, N>> params (count / N);
+        std::vector<Accumulator<Batch<T, N>>> accs (params.size());
+        for (size_t j = 0; j < params.size(); ++j) {
+            for (size_t lane = 0; lane < N; ++lane) {
+                params[j][lane] = values[j * N + lane];
+            }
+        }
+        sweepDomain<var, param, T>(stepper, f, args, D, params, accs);
+        for (size_t j = 0; j < accs.size(); ++j) {
+            const auto result = accs[j].result();
+            for (size_t lane = 0; lane < N; ++lane) {
+                out[j * N + lane] = result[lane];
+            }
+        }
+        batched = params.size() * N;
+    }
+    if (batched < count) {
+        std::vector<T> params (values + batched, values + count);
+        std::vector<Accumulator<T>> accs (params.size());
+        sweepDomain<var, param, T>(stepper, f, args, D, params, accs);
+        for (size_t j = 0; j < accs.size(); ++j) {
+            out[batched + j] = accs[j].result();
+        }
+    }
+}
+
+} // detail
+
+/**
+ * Integrates function for many values of one of its other arguments (parameter) in a single traversal of the domain.
+ *
+ * For every point of the domain, f is evaluated for all parameter values, so the domain is not regenerated
+ * and f is not rebound per value. If f supports batches (see batched()), it's called with batches of parameter
+ * values. Parallel policy splits values into chunks of sweepChunkSize, each of which traverses the domain.
+ * Results do not depend on policy.
+ * @tparam Stepper - stepper to be used for computing numerical integral, e.g. Simpson.
+ * @tparam var - index of integration variable.
+ * @tparam param - index of parameter.
+ * @tparam T - floating point type to use (usually deduced).
+ * @tparam Accumulator - summation method, e.g. NaiveSum, KahanSum, NeumaierSum or PairwiseSum.
+ * @tparam Policy - execution policy type (usually deduced).
+ * @tparam F - type of function object (usually deduced).
+ * @param policy - execution policy, e.g. execution::par.
+ * @param f - function object of at least two arguments.
+ * @return New function object of (D, values, x0...), where D is either Range<T> or QuadratureRule<T>, values are
+ * contiguous parameter values (e.g. std::vector<T>), and x0 are values of all arguments of f (those at var
+ * and param are ignored, e.g. dVar). It returns std::vector<T> of integrals, one per parameter value.
+ */
+template <
+    template <typename> typename Stepper, size_t var = 0, size_t param = (var == 0 ? 1 : 0), typename T = double,
+    template <typename> typename Accumulator = NaiveSum, typename Policy, typename F,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+auto integralSweep(Policy policy, F f) {
+    static_assert(var != param, "Parameter should differ from integration variable");
     Stepper<T> stepper;
-    return [=] (Range<T> D, auto... x0) {
+    return [=] (const auto& D, const auto& values, auto... x0) {
+        static_assert(var < sizeof...(x0) && param < sizeof...(x0), "Index of variable is out of range");
+        const auto args = std::make_tuple(x0...);
+        const T* data = std::data(values);
+        const size_t count = std::size(values);
+        std::vector<T> result (count);
+        const size_t chunkSize = execution::isParallelPolicy<Policy> ? detail::sweepChunkSize : count;
+        const size_t chunks = chunkSize > 0 ? (count + chunkSize - 1) / chunkSize : 0;
+        detail::forEachIndex(policy, chunks, [&](size_t chunk) {
+            const size_t first = chunk * chunkSize;
+            detail::sweepValues<Accumulator, var, param>(stepper, f, args, D, data + first,
+                                                         std::min(chunkSize, count - first), result.data() + first);
+        });
+        return result;
+    };
+}
+
+/**
+ * Integrates function for many values of one of its other arguments (parameter) in a single traversal of the domain.
+ * @tparam Stepper - stepper to be used for computing numerical integral, e.g. Simpson.
+ * @tparam var - index of integration variable.
+ * @tparam param - index of parameter.
+ * @tparam T - floating point type to use (usually deduced).
+ * @tparam Accumulator - summation method, e.g. NaiveSum, KahanSum, NeumaierSum or PairwiseSum.
+ * @tparam F - type of function object (usually deduced).
+ * @param f - function object of at least two arguments.
+ * @return New function object of (D, values, x0...), which returns std::vector<T> of integrals.
+ */
+template <
+    template <typename> typename Stepper, size_t var = 0, size_t param = (var == 0 ? 1 : 0), typename T = double,
+    template <typename> typename Accumulator = NaiveSum, typename F
+>
+auto integralSweep(F f) {
+    return integralSweep<Stepper, var, param, T, Accumulator>(execution::seq, f);
+}
+
+namespace detail {
+
+/**
+ * Quadrature rule of one axis of tensor product: QuadratureRule itself, or Range tabulated with Stepper.
+ * Tabulated rules are owned by the caller and live only as long as the integral is computed.
+ */
+template <template <typename> typename Stepper, typename T, typename Domain>
+std::shared_ptr<const QuadratureRule<T>> axisRule(const Domain& D) {
+    if constexpr (std::is_same_v<Domain, QuadratureRule<T>>) {
+        return std::shared_ptr<const QuadratureRule<T>> { std::shared_ptr<void> {}, &D }; // non-owning
+    } else {
+        static_assert(hasFixedNodes<Stepper, T>, "Stepper nodes depend on function values and can't be tabulated");
+        auto rule = QuadratureRule<T>::template fromRange<Stepper>(Range<T> { D });
+        return std::make_shared<const QuadratureRule<T>>(std::move(rule));
+    }
+}
+
+template <typename F, typename T, size_t D, typename Y, size_t ... I>
+inline auto callWithLast(const F& f, const std::array<T, D>& x, const Y& y, std::index_sequence<I...>) {
+    return f(x[I]..., y);
+}
+
+/**
+ * Integrates f over tensor product of 1D rules.
+ *
+ * Nodes are enumerated by a flat index over all axes except the last one; for every such node the last axis
+ * is integrated as a contiguous (and, if f supports batches, batched) 1D sum. Flat index is split into chunks
+ * of about integralChunkSize nodes, which parallel policy processes concurrently.
+ */
+template <template <typename> typename Accumulator, typename T, size_t D, typename Policy, typename F>
+T integrateTensorProduct(Policy policy, const F& f, const std::array<const QuadratureRule<T>*, D>& rules) {
+    const QuadratureRule<T>& inner = *rules[D - 1];
+    size_t outerCount = 1;
+    for (size_t k = 0; k + 1 < D; ++k) {
+        outerCount *= rules[k]->size();
+    }
+    const size_t chunkSize = std::max<size_t>(1, integralChunkSize / std::max<size_t>(1, inner.size()));
+    return reduceChunks<Accumulator, T>(policy, outerCount, [&](size_t first, size_t last) {
+        std::array<size_t, D - 1> index;
+        for (size_t k = D - 1, flat = first; k-- > 0;) {
+            index[k] = flat % rules[k]->size();
+            flat /= rules[k]->size();
+        }
+        std::array<T, D - 1> x;
+        Accumulator<T> acc;
+        for (size_t outer = first; outer < last; ++outer) {
+            T weight = 1;
+            for (size_t k = 0; k + 1 < D; ++k) {
+                x[k] = rules[k]->nodes()[index[k]];
+                weight *= rules[k]->weights()[index[k]];
+            }
+            const auto bound = [&f, &x](auto y) {
+                return callWithLast(f, x, y, std::make_index_sequence<D - 1> {});
+            };
+            if constexpr (batchSizeOf<F> > 0) {
+                acc.add(weight * inner.template integrate<Accumulator>(batched<batchSizeOf<F>>(bound)));
+            } else {
+                acc.add(weight * inner.template integrate<Accumulator>(bound));
+            }
+            for (size_t k = D - 1; k-- > 0;) {
+                if (++index[k] < rules[k]->size()) {
+                    break;
+                }
+                index[k] = 0;
+            }
+        }
+        return acc.result();
+    }, chunkSize);
+}
+
+} // detail
+
+/**
+ * Integrates function of several variables over all of them at once.
+ *
+ * Unlike nested integral objects, the whole point set is traversed in a single flat loop, without rebinding
+ * f for every value of outer variables.
+ * @tparam Stepper - stepper to tabulate ranges with, e.g. Simpson.
+ * @tparam T - floating point type to use (usually deduced).
+ * @tparam Accumulator - summation method, e.g. NaiveSum, KahanSum, NeumaierSum or PairwiseSum.
+ * @tparam Policy - execution policy type (usually deduced).
+ * @tparam F - type of function object (usually deduced).
+ * @param policy - execution policy, e.g. execution::par.
+ * @param f - function object of D arguments.
+ * @return New function object, representing numerical integral of f. Its argument is either a tuple of D domains
+ * (Range<T> or QuadratureRule<T>, one per argument of f; integral is computed over their tensor product),
+ * or CubatureRule<T, D> (e.g. CubatureRule<T, D>::smolyak sparse grid).
+ */
+template <
+    template <typename> typename Stepper, typename T = double,
+    template <typename> typename Accumulator = NaiveSum, typename Policy, typename F,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+auto multiIntegral(Policy policy, F f) {
+    return [=] (const auto& domain) {
+        using Domain = std::decay_t<decltype(domain)>;
+        if constexpr (isCubatureRule<Domain>) {
+            return detail::reduceChunks<Accumulator, T>(policy, domain.size(), [&](size_t first, size_t last) {
+                return domain.template integrate<Accumulator>(f, first, last);
+            });
+        } else {
+            return std::apply([&](const auto& ... domains) {
+                const std::array<std::shared_ptr<const QuadratureRule<T>>, sizeof...(domains)> rules {
+                    detail::axisRule<Stepper, T>(domains)...
+                };
+                std::array<const QuadratureRule<T>*, sizeof...(domains)> pointers;
+                std::transform(rules.begin(), rules.end(), pointers.begin(), [](const auto& r) { return r.get(); });
+                return detail::integrateTensorProduct<Accumulator, T>(policy, f, pointers);
+            }, domain);
+        }
+    };
+}
+
+/**
+ * Integrates function of several variables over all of them at once.
+ * @tparam Stepper - stepper to tabulate ranges with, e.g. Simpson.
+ * @tparam T - floating point type to use (usually deduced).
+ * @tparam Accumulator - summation method, e.g. NaiveSum, KahanSum, NeumaierSum or PairwiseSum.
+ * @tparam F - type of function object (usually deduced).
+ * @param f - function object of D arguments.
+ * @return New function object, representing numerical integral of f.
+ */
+template <
+    template <typename> typename Stepper, typename T = double,
+    template <typename> typename Accumulator = NaiveSum, typename F
+>
+auto multiIntegral(F f) {
+    return multiIntegral<Stepper, T, Accumulator>(execution::seq, f);
+}
+
+/**
+ * Parameters of Monte Carlo integration.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+struct MonteCarloOptions {
+    /**
+     * Sampling stops when estimated error is below max(absTol, relTol * |value|), or maxSamples is reached.
+     */
+    T absTol = 0;
+    T relTol = T(1e-3);
+    /**
+     * Number of samples per replicate taken at first; it is doubled until tolerance is met.
+     */
+    size_t minSamples = 1 << 10;
+    /**
+     * Limit of samples per replicate; it is clamped to the number of distinct points of the sequence (2^32 for
+     * Sobol), since further indices would repeat points.
+     */
+    size_t maxSamples = 1 << 24;
+    /**
+     * Number of independently randomized replicates of quasi-random sequences, whose spread gives error estimate
+     * (pseudo-random sampling uses sample variance instead and a single stream).
+     */
+    size_t replicates = 8;
+    uint64_t seed = 0;
+};
+
+/**
+ * Result of Monte Carlo integration.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+struct MonteCarloResult {
+    T value;
+    /**
+     * Estimated standard error.
+     */
+    T error;
+    /**
+     * Total number of function evaluations.
+     */
+    size_t samples;
+    /**
+     * Whether requested tolerance was reached before running out of samples.
+     */
+    bool converged;
+
+    inline operator T() const noexcept {
+        return value;
+    }
+};
+
+namespace detail {
+
+/**
+ * Number of samples of a replicate processed by a single task of monteCarloIntegral.
+ */
+constexpr size_t monteCarloChunkSize = 1 << 12;
+constexpr size_t monteCarloMaxDimension = 64;
+
+/**
+ * Collects statistics of f (scaled by volume of the box) over points [first, last) of sequence.
+ *
+ * Coordinates of a point are mapped to the box and substituted into args at positions; if f supports batches,
+ * batchSizeOf<F> points are evaluated at a time.
+ */
+template <typename T, typename Sequence, typename F, size_t A>
+RunningStatistics<T> sampleChunk(const Sequence& sequence, const F& f, const std::array<T, A>& args,
+                                 const std::vector<size_t>& positions, const std::vector<std::pair<T, T>>& box,
+                                 T volume, uint64_t first, uint64_t last) {
+    const size_t dimension = positions.size();
+    T point[monteCarloMaxDimension];
+    RunningStatistics<T> statistics;
+    const auto call = [&f](const auto& x) {
+        return std::apply([&f](const auto& ... xs) { return f(xs...); }, x);
+    };
+    if constexpr (constexpr size_t N = batchSizeOf<F>; N > 0) {
+        std::array<Batch<T, N>, A> x;
+        for (size_t i = 0; i < A; ++i) {
+            x[i] = Batch<T, N>::broadcast(args[i]);
+        }
+        for (; first + N <= last; first += N) {
+            for (size_t lane = 0; lane < N; ++lane) {
+                sequence.point(first + lane, point);
+                for (size_t k = 0; k < dimension; ++k) {
+                    x[positions[k]][lane] = box[k].first + (box[k].second - box[k].first) * point[k];
+                }
+            }
+            const auto y = asBatch<T, N>(call(x));
+            for (size_t lane = 0; lane < N; ++lane) {
+                statistics.add(volume * y[lane]);
+            }
+        }
+    }
+    std::array<T, A> x = args;
+    for (; first < last; ++first) {
+        sequence.point(first, point);
+        for (size_t k = 0; k < dimension; ++k) {
+            x[positions[k]] = box[k].first + (box[k].second - box[k].first) * point[k];
+        }
+        statistics.add(volume * call(x));
+    }
+    return statistics;
+}
+
+} // detail
+
+/**
+ * Integrates function over a box with Monte Carlo or randomized quasi-Monte Carlo method.
+ *
+ * Samples are taken in rounds, doubling their number until estimated error meets tolerance. Every round is
+ * split into chunks of monteCarloChunkSize points, which parallel policy processes concurrently; since points
+ * are computed directly from their indices (see Random.hpp) and chunk statistics are merged in fixed order,
+ * results are reproducible and do not depend on policy or number of threads.
+ * @tparam Sequence - point set: PseudoRandom, Sobol or Halton.
+ * @tparam T - floating point type to use (usually deduced).
+ * @tparam Policy - execution policy type (usually deduced).
+ * @tparam F - type of function object (usually deduced).
+ * @param policy - execution policy, e.g. execution::par.
+ * @param f - function object.
+ * @param options - tolerances, sample limits and seed.
+ * @return New function object of (box, x0...), where box lists intervals {from, to} of integration variables,
+ * and x0 are values of all arguments of f with dVar in place of integration variables (may be omitted if
+ * f has a single argument). It returns MonteCarloResult (convertible to T).
+ */
+template <
+    template <typename> typename Sequence = Sobol, typename T = double, typename Policy, typename F,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+auto monteCarloIntegral(Policy policy, F f, MonteCarloOptions<T> options = {}) {
+    return [=] (const std::vector<std::pair<T, T>>& box, auto... x0) -> MonteCarloResult<T> {
         if constexpr (sizeof...(x0) == 0) {
-            return std::accumulate(D.begin(), D.end(), 0.0,
-                                   [stepper, f, D](T acc, T x) { return acc + stepper(f, D.step(), x); });
+            return monteCarloIntegral<Sequence, T>(policy, f, options)(box, dVar);
         } else {
-            auto fBound = [f, x0...](auto x) mutable { // todo heavy lambda?
-                auto _tX0 = std::forward_as_tuple(std::forward<decltype(x0)>(x0)...);
-                std::get<var>(_tX0) = x;
-                return f(x0...);
+            const std::array<T, sizeof...(x0)> args { static_cast<T>(x0)... };
+            std::vector<size_t> positions;
+            for (size_t i = 0; i < args.size(); ++i) {
+                if (std::isnan(args[i])) {
+                    positions.push_back(i);
+                }
+            }
+            if (positions.size() != box.size()) {
+                throw std::invalid_argument("Number of intervals differs from number of integration variables");
+            }
+            if (box.size() > detail::monteCarloMaxDimension) {
+                throw std::invalid_argument("Too many integration variables");
+            }
+            T volume = 1;
+            for (const auto& [from, to] : box) {
+                volume *= to - from;
+            }
+
+            const size_t replicates = Sequence<T>::quasiRandom ? std::max<size_t>(2, options.replicates) : 1;
+            std::vector<Sequence<T>> sequences;
+            for (size_t r = 0; r < replicates; ++r) {
+                sequences.emplace_back(box.size(), options.seed, r);
+            }
+            std::vector<RunningStatistics<T>> statistics (replicates);
+
+            MonteCarloResult<T> result { 0, 0, 0, false };
+            const size_t maxSamples = static_cast<size_t>(std::min<uint64_t>(options.maxSamples,
+                                                                             Sequence<T>::maxPoints));
+            size_t taken = 0;
+            for (size_t target = std::max<size_t>(1, options.minSamples); ; target *= 2) {
+                target = std::min(target, maxSamples);
+                const size_t chunks = (target - taken + detail::monteCarloChunkSize - 1) / detail::monteCarloChunkSize;
+                std::vector<RunningStatistics<T>> partials (replicates * chunks);
+                detail::forEachIndex(policy, partials.size(), [&](size_t task) {
+                    const size_t r = task / chunks;
+                    const uint64_t first = taken + (task % chunks) * detail::monteCarloChunkSize;
+                    const uint64_t last = std::min<uint64_t>(first + detail::monteCarloChunkSize, target);
+                    partials[task] = detail::sampleChunk(sequences[r], f, args, positions, box, volume, first, last);
+                });
+                for (size_t task = 0; task < partials.size(); ++task) {
+                    statistics[task / chunks].merge(partials[task]);
+                }
+                taken = target;
+
+                if (replicates == 1) {
+                    result.value = statistics[0].mean;
+                    result.error = std::sqrt(statistics[0].variance() / taken);
+                } else {
+                    RunningStatistics<T> means;
+                    for (const auto& replicate : statistics) {
+                        means.add(replicate.mean);
+                    }
+                    result.value = means.mean;
+                    result.error = std::sqrt(means.variance() / replicates);
+                }
+                result.samples = taken * replicates;
+                result.converged = result.error <= std::max(options.absTol, options.relTol * std::abs(result.value));
+                if (result.converged || taken >= maxSamples) {
+                    return result;
+                }
+            }
+        }
+    };
+}
+
+/**
+ * Integrates function over a box with Monte Carlo or randomized quasi-Monte Carlo method.
+ * @tparam Sequence - point set: PseudoRandom, Sobol or Halton.
+ * @tparam T - floating point type to use (usually deduced).
+ * @tparam F - type of function object (usually deduced).
+ * @param f - function object.
+ * @param options - tolerances, sample limits and seed.
+ * @return New function object of (box, x0...), which returns MonteCarloResult.
+ */
+template <template <typename> typename Sequence = Sobol, typename T = double, typename F>
+auto monteCarloIntegral(F f, MonteCarloOptions<T> options = {}) {
+    return monteCarloIntegral<Sequence, T>(execution::seq, f, options);
+}
+
+/**
+ * Integrates function adaptively, subdividing interval only where error estimate of the rule is too large.
+ *
+ * Subintervals are kept in a heap ordered by their error estimate; the worst one is bisected until the total
+ * estimated error is below max(absTol, relTol * |value|) or maxIntervals is reached.
+ * @tparam Rule - quadrature rule providing error estimate, e.g. GK21.
+ * @tparam var - index of integration variable.
+ * @tparam T - floating point type to use (usually deduced).
+ * @tparam F - type of function object (usually deduced).
+ * @param f - function object.
+ * @param absTol - requested absolute error.
+ * @param relTol - requested relative error.
+ * @param maxIntervals - maximal number of subintervals.
+ * @return New function object of (from, to, x0...), representing numerical integral of f over [from, to].
+ * It returns QuadratureResult (convertible to T), which also holds error estimate and number of evaluations used.
+ */
+template <
+    template <typename> typename Rule = GK21, size_t var = 0, typename T = double, typename F
+>
+auto adaptiveIntegral(F f,
+                      T absTol = PrecisionTraits<T>::quadratureTolerance(),
+                      T relTol = PrecisionTraits<T>::quadratureTolerance(),
+                      size_t maxIntervals = 1000) {
+    Rule<T> rule;
+    return [=] (T from, T to, auto... x0) {
+        struct Interval {
+            T from, to;
+            QuadratureEstimate<T> estimate;
+            bool operator<(const Interval& other) const { return estimate.error < other.estimate.error; }
+        };
+
+        const auto integrate = [&](auto fBound) {
+            std::vector<Interval> heap;
+            heap.reserve(maxIntervals);
+            heap.push_back({ from, to, rule.estimate(fBound, from, to) });
+            T value = heap.front().estimate.value;
+            T error = heap.front().estimate.error;
+
+            while (error > std::max(absTol, relTol * std::abs(value)) && heap.size() < maxIntervals) {
+                std::pop_heap(heap.begin(), heap.end());
+                const Interval worst = heap.back();
+                heap.pop_back();
+                const T middle = (worst.from + worst.to) / 2;
+                const Interval left  { worst.from, middle, rule.estimate(fBound, worst.from, middle) };
+                const Interval right { middle, worst.to, rule.estimate(fBound, middle, worst.to) };
+                value += left.estimate.value + right.estimate.value - worst.estimate.value;
+                error += left.estimate.error + right.estimate.error - worst.estimate.error;
+                heap.push_back(left);
+                std::push_heap(heap.begin(), heap.end());
+                heap.push_back(right);
+                std::push_heap(heap.begin(), heap.end());
+            }
+
+            // recompute totals to get rid of cancellation accumulated by incremental updates
+            NeumaierSum<T> totalValue, totalError;
+            for (const auto& interval : heap) {
+                totalValue.add(interval.estimate.value);
+                totalError.add(interval.estimate.error);
+            }
+            const size_t intervals = heap.size();
+            return QuadratureResult<T> {
+                totalValue.result(), totalError.result(), (2 * intervals - 1) * Rule<T>::points, intervals,
+                totalError.result() <= std::max(absTol, relTol * std::abs(totalValue.result()))
             };
-            return std::accumulate(D.begin(), D.end(), 0.0,
-                                   [stepper, fBound, D](T acc, T x) { return acc + stepper(fBound, D.step(), x); });
+        };
+
+        if constexpr (sizeof...(x0) == 0) {
+            return integrate(f);
+        } else {
+            return integrate(detail::bindVar<var>(f, x0...));
         }
     };
 }
@@ -134,48 +905,49 @@ auto integral(F f) {
  */
 template <typename T>
 struct Euler {
-    template <typename F>
-    T operator()(F f, T h, T x) const {
+    template <typename F, typename X>
+    auto operator()(const F& f, T h, X x) const {
         return h * f(x);
     }
+
+    template <typename Emit>
+    void cellNodes(T h, T x, Emit&& emit) const {
+        emit(x, h);
+    }
 };
 
 /**
  * Runge-Kutta 4th order integral stepper.
+ *
+ * For y' = f(x) the classic RK4 step reduces to Simpson's rule (k2 = k3 = f(x + h/2)), which is what it is.
  * @tparam T - floating point type to use (usually deduced)
  */
 template <typename T>
-struct RK4 {
-    template <typename F>
-    T operator()(F f, T h, T x) const {
-        const auto k1 = f(x);
-        const auto k2 = f(x + k1 * h / 2);
-        const auto k3 = f(x + k2 * h / 2);
-        const auto k4 = f(x + k3 * h);
-        return h / 6.0 * (k1 + 2*k2 + 2*k3 + k4);
-    }
-};
+using RK4 = Simpson<T>;
 
 /**
  * Makes inner (sub-integral) product of an arbitrary number of functions.
  * @tparam Stepper - stepper to use for integration.
  * @tparam var - index of integration variable.
  * @tparam T - floating point type to use (usually deduced).
+ * @tparam Accumulator - summation method to use for integration.
  * @tparam Fs - type of function object (usually deduced).
  * @param functions - function object to make inner product of.
  * @return New function object, representing inner product of given functions.
  */
 template <
-    template <typename> typename Stepper, size_t var = 0, typename T = double, typename ... Fs
+    template <typename> typename Stepper, size_t var = 0, typename T = double,
+    template <typename> typename Accumulator = NaiveSum, typename ... Fs
 >
 auto innerProduct(Fs ... functions) {
     const auto pr = product(functions...);
-    return integral<Stepper, var, T>([=](auto... x) { return pr( x... ); });
+    return integral<Stepper, var, T, Accumulator>([=](auto... x) { return pr( x... ); });
 }
 
 /**
  * Differentiates a function.
- * @tparam DiffMethod - method to use for differentiation, e.g. LFD1 (left-sided finite difference 1st order scheme).
+ * @tparam DiffMethod - method to use for differentiation, e.g. LFD1 (left-sided finite difference 1st order scheme)
+ * or AutoDiff (exact derivatives of generic functions).
  * @tparam order - order of derivative to take.
  * @tparam var - index of variable to differentiate by
  * @tparam T - floating point type to use (usually deduced).
@@ -191,117 +963,350 @@ auto D(F f) {
     return [=](auto... x) { return method.template compute<order, var>(f, x...); };
 }
 
+namespace detail {
+
+enum class StencilSide { left, right, central };
+
 /**
- * Left-sided finite difference scheme of 1st order.
+ * Offset (in steps) of the first point of finite difference stencil for derivative of given order, which has
+ * given order of accuracy: left-sided stencils end at 0, right-sided ones start at 0, central ones are symmetric.
+ */
+constexpr int stencilFirst(StencilSide side, size_t order, size_t accuracy) {
+    switch (side) {
+    case StencilSide::left:
+        return -static_cast<int>(order + accuracy - 1);
+    case StencilSide::right:
+        return 0;
+    default:
+        return -static_cast<int>((order + 1) / 2 - 1 + accuracy / 2);
+    }
+}
+
+/**
+ * Number of points of finite difference stencil (see stencilFirst).
+ */
+constexpr size_t stencilWidth(StencilSide side, size_t order, size_t accuracy) {
+    return side == StencilSide::central ? 1 - 2 * stencilFirst(side, order, accuracy) : order + accuracy;
+}
+
+/**
+ * Weights of finite difference approximation of derivative of given order at 0 on points first, first + 1, ...
+ * (in units of step), computed with Fornberg's algorithm ("Generation of finite difference formulas on
+ * arbitrarily spaced grids", 1988). Weights for all lower orders are built up along the way, one point at a time.
+ */
+template <typename T, size_t order, size_t width>
+constexpr std::array<T, width> fornbergWeights(int first) {
+    std::array<std::array<T, order + 1>, width> c {};
+    T c1 = 1;
+    T c4 = static_cast<T>(first);
+    c[0][0] = 1;
+    for (size_t i = 1; i < width; ++i) {
+        const size_t mn = i < order ? i : order;
+        const T c5 = c4;
+        T c2 = 1;
+        c4 = static_cast<T>(first + static_cast<int>(i));
+        for (size_t j = 0; j < i; ++j) {
+            const T c3 = static_cast<T>(static_cast<int>(i) - static_cast<int>(j));
+            c2 *= c3;
+            if (j == i - 1) {
+                for (size_t k = mn; k >= 1; --k) {
+                    c[i][k] = c1 * (static_cast<T>(k) * c[i - 1][k - 1] - c5 * c[i - 1][k]) / c2;
+                }
+                c[i][0] = -c1 * c5 * c[i - 1][0] / c2;
+            }
+            for (size_t k = mn; k >= 1; --k) {
+                c[j][k] = (c4 * c[j][k] - static_cast<T>(k) * c[j][k - 1]) / c3;
+            }
+            c[j][0] = c4 * c[j][0] / c3;
+        }
+        c1 = c2;
+    }
+    std::array<T, width> weights {};
+    for (size_t j = 0; j < width; ++j) {
+        weights[j] = c[j][order];
+    }
+    return weights;
+}
+
+/**
+ * Weights of stencils of given width for every position of the differentiation point within the stencil:
+ * stencils[s] covers points -s .. width - 1 - s. Used near ends of sampled arrays, where the preferred stencil
+ * does not fit, and is shifted inwards keeping its width (and accuracy).
+ */
+template <typename T, size_t order, size_t width>
+constexpr std::array<std::array<T, width>, width> shiftedStencils() {
+    std::array<std::array<T, width>, width> stencils {};
+    for (size_t s = 0; s < width; ++s) {
+        stencils[s] = fornbergWeights<T, order, width>(-static_cast<int>(s));
+    }
+    return stencils;
+}
+
+} // detail
+
+/**
+ * Finite difference scheme of given order of accuracy, for derivatives of any order.
+ *
+ * Stencil weights are generated at compile time (see detail::fornbergWeights) for every order of derivative
+ * requested from compute(), and points with zero weight (e.g. the center of central schemes for odd
+ * derivatives) are not evaluated. Step is chosen to balance truncation and rounding errors
+ * (see PrecisionTraits::derivativeStep).
  * @tparam T - floating point type to use (usually deduced)
+ * @tparam side - position of stencil relative to differentiation point.
+ * @tparam accuracy - order of accuracy: error is O(h^accuracy).
  */
-template <typename T>
-struct LFD1 {
+template <typename T, detail::StencilSide side, size_t accuracy>
+struct FiniteDifference {
+    static_assert(accuracy > 0, "Order of accuracy should be positive");
+    static_assert(side != detail::StencilSide::central || accuracy % 2 == 0,
+                  "Central schemes have even order of accuracy");
+
+    template <size_t order>
+    static constexpr int first = detail::stencilFirst(side, order, accuracy);
+
+    template <size_t order>
+    static constexpr size_t width = detail::stencilWidth(side, order, accuracy);
+
+    template <size_t order>
+    static constexpr std::array<T, width<order>> weights =
+        detail::fornbergWeights<T, order, width<order>>(first<order>);
+
+    template <size_t order>
+    static inline const T step = PrecisionTraits<T>::derivativeStep(order, accuracy);
+
     template <size_t order, size_t var, typename F, typename ...Args>
     auto compute(F f, Args... x) const { // not operator() to more intuitive template args
-        const auto h = PrecisionTraits<T>::derivativePrecision(order);
-        const auto base = f(x...);
-        auto vars = std::forward_as_tuple(std::forward<decltype(x)>(x)...);
-        std::get<var>(vars) -= h;
-        const auto left = f(x...);
-        auto result = ( base - left ) / h;
+        static_assert(var < sizeof...(Args), "Index of differentiation variable is out of range");
+        const T h = step<order>;
+        const auto args = std::make_tuple(x...);
+        const auto x0 = std::get<var>(args);
+        const auto at = [&](size_t k) {
+            const auto xk = x0 + static_cast<T>(first<order> + static_cast<int>(k)) * h;
+            return weights<order>[k] * detail::callWithVar<var>(f, args, xk, std::index_sequence_for<Args...> {});
+        };
+        auto result = at(0);
+        for (size_t k = 1; k < width<order>; ++k) {
+            if (weights<order>[k] != 0) {
+                result += at(k);
+            }
+        }
+        for (size_t k = 0; k < order; ++k) {
+            result /= h;
+        }
         return result;
     }
 };
 
+/**
+ * Left-sided finite difference scheme of 1st order.
+ * @tparam T - floating point type to use (usually deduced)
+ */
+template <typename T>
+using LFD1 = FiniteDifference<T, detail::StencilSide::left, 1>;
+
 /**
  * Left-sided finite difference scheme of 2nd order.
  * @tparam T - floating point type to use (usually deduced)
  */
 template <typename T>
-struct LFD2 {
-    template <size_t order, size_t var, typename F, typename ...Args>
-    auto compute(F f, Args... x) const {
-        const auto h = PrecisionTraits<T>::derivativePrecision(order);
-        auto vars = std::forward_as_tuple(std::forward<decltype(x)>(x)...);
-        const auto base  = f(x...);
-        std::get<var>(vars) -= h;
-        const auto left  = f(x...);
-        std::get<var>(vars) += 2.0 * h;
-        const auto right = f(x...);
-        return ( 3.0*base - 4.0*left + right ) / (2.0 * h);
-    }
-};
+using LFD2 = FiniteDifference<T, detail::StencilSide::left, 2>;
 
 /**
  * Right-sided finite difference scheme of 1st order.
  * @tparam T - floating point type to use (usually deduced)
  */
 template <typename T>
-struct RFD1;
+using RFD1 = FiniteDifference<T, detail::StencilSide::right, 1>;
 
 /**
  * Right-sided finite difference scheme of 2nd order.
  * @tparam T - floating point type to use (usually deduced)
  */
 template <typename T>
-struct RFD2;
+using RFD2 = FiniteDifference<T, detail::StencilSide::right, 2>;
 
 /**
  * Central finite difference scheme of 2nd order.
  * @tparam T - floating point type to use (usually deduced)
  */
 template <typename T>
-struct CFD2;
+using CFD2 = FiniteDifference<T, detail::StencilSide::central, 2>;
 
 /**
- * Left-sided finite difference scheme of 4th order.
+ * Central finite difference scheme of 4th order.
  * @tparam T - floating point type to use (usually deduced)
  */
 template <typename T>
-struct CFD4;
+using CFD4 = FiniteDifference<T, detail::StencilSide::central, 4>;
 
 /**
- * Naive Gaussian elimination implementation
+ * Exact differentiation with forward mode automatic differentiation.
+ *
+ * Variable var is passed to f as Taylor series of degree order (a dual number for the first derivative), other
+ * arguments are passed as is, so that a single evaluation of f gives the derivative without truncation and
+ * cancellation errors of finite differences. f should be generic, i.e. accept Taylor arguments (as
+ * ChebyshevBasis, PolynomialBasis and generic lambdas calling math functions unqualified do); arguments may be
+ * scalars or Batch values.
+ * @tparam T - floating point type to use (usually deduced)
  */
 template <typename T>
-std::vector<T> eliminate(Surface<T>&& A) {
-    size_t N = A.rowCount();
-
-    for (size_t i = 0; i < N; ++i) {
-        // Search for maximum in this column
-        T maxEl = std::abs( A.at(i, i) );
-        size_t maxRow = i;
-        for (size_t k = i + 1; k < N; ++k) {
-            const T el = std::abs(A.at(k, i));
-            if (el > maxEl) {
-                maxEl = el; maxRow = k;
-            }
+struct AutoDiff {
+    template <size_t order, size_t var, typename F, typename ...Args>
+    auto compute(F f, Args... x) const {
+        static_assert(var < sizeof...(Args), "Index of differentiation variable is out of range");
+        using X = std::tuple_element_t<var, std::tuple<Args...>>;
+        using V = std::conditional_t<std::is_arithmetic_v<X>, T, X>;
+        const auto seed = Taylor<V, order>::variable(static_cast<V>(std::get<var>(std::make_tuple(x...))));
+        const auto y = detail::callWithVar<var>(f, std::make_tuple(x...), seed, std::index_sequence_for<Args...> {});
+        if constexpr (isTaylor<decltype(y)>) {
+            return y.derivative(order);
+        } else {
+            return broadcastTo<V>(0); // f does not depend on the variable
         }
+    }
+};
 
-        if (maxRow != i) {
-            // Swap maximum row with current row (column by column)
-            for (size_t k = i; k < N + 1; ++k) {
-                std::swap(A.at(maxRow, k), A.at(i, k));
+/**
+ * Differentiates sampled function: applies finite difference stencil of DiffMethod to the whole array of samples.
+ *
+ * Every sample is used by all stencils covering it, so differentiating M samples takes M function evaluations
+ * instead of M times stencil width with D. Near ends of the array stencils are shifted inwards, keeping their
+ * width, so all results have the same order of accuracy.
+ * @tparam DiffMethod - finite difference scheme, e.g. CFD4.
+ * @tparam order - order of derivative to take.
+ * @tparam T - floating point type (usually deduced).
+ * @tparam Policy - execution policy type (usually deduced).
+ * @param policy - execution policy, e.g. execution::par.
+ * @param samples - values of function at equidistant points.
+ * @param h - distance between points.
+ * @return Derivatives at the same points.
+ */
+template <
+    template <typename> typename DiffMethod, size_t order = 1, typename T, typename Policy,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+std::vector<T> differentiate(Policy policy, const std::vector<T>& samples, T h) {
+    using Method = DiffMethod<T>;
+    constexpr size_t width = Method::template width<order>;
+    constexpr int first = Method::template first<order>;
+    static_assert(first <= 0, "stencil must contain the point of differentiation");
+    constexpr size_t before = static_cast<size_t>(-first); // stencil points before the point of differentiation
+    static constexpr auto stencils = detail::shiftedStencils<T, order, width>();
+    constexpr auto& interior = stencils[before];
+
+    const size_t n = samples.size();
+    if (n < width) {
+        throw std::invalid_argument("Too few samples for finite difference stencil");
+    }
+    T scale = 1;
+    for (size_t k = 0; k < order; ++k) {
+        scale /= h;
+    }
+    std::vector<T> result (n);
+    const size_t chunks = (n + detail::integralChunkSize - 1) / detail::integralChunkSize;
+    detail::forEachIndex(policy, chunks, [&](size_t chunk) {
+        const size_t begin = chunk * detail::integralChunkSize;
+        const size_t end = std::min(begin + detail::integralChunkSize, n);
+        // stencil fits entirely for i in [before, n - width + before]
+        const size_t interiorBegin = std::max(begin, before);
+        const size_t interiorEnd = std::max(interiorBegin, std::min(end, n - width + before + 1));
+        const auto boundary = [&](size_t i) {
+            const size_t start = std::min(i < before ? 0 : i - before, n - width);
+            const auto& weights = stencils[i - start];
+            T sum = 0;
+            for (size_t k = 0; k < width; ++k) {
+                sum += weights[k] * samples[start + k];
             }
+            result[i] = sum * scale;
+        };
+        for (size_t i = begin; i < interiorBegin; ++i) {
+            boundary(i);
         }
-
-        // eliminate rows below
-        for (size_t k = i + 1; k < N; ++k) {
-            T c = -A.at(k, i) / A.at(i, i);
-            for (size_t j = i; j < N + 1; ++j) {
-                if (i == j) {
-                    A.at(k, j) = 0;
-                } else {
-                    A.at(k, j) += c * A.at(i, j);
-                }
+        for (size_t i = interiorBegin; i < interiorEnd; ++i) {
+            const T* x = samples.data() + (i - before);
+            T sum = 0;
+            for (size_t k = 0; k < width; ++k) {
+                sum += interior[k] * x[k];
             }
+            result[i] = sum * scale;
         }
+        for (size_t i = interiorEnd; i < end; ++i) {
+            boundary(i);
+        }
+    });
+    return result;
+}
+
+/**
+ * Differentiates sampled function sequentially (see the overload with execution policy).
+ */
+template <template <typename> typename DiffMethod, size_t order = 1, typename T>
+std::vector<T> differentiate(const std::vector<T>& samples, T h) {
+    return differentiate<DiffMethod, order>(execution::seq, samples, h);
+}
+
+/**
+ * Differentiates function on all points of range: tabulates f once (in batches, if f supports them) and
+ * differentiates the samples (see the overload taking samples).
+ */
+template <
+    template <typename> typename DiffMethod, size_t order = 1, typename T, typename Policy, typename F,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+std::vector<T> differentiate(Policy policy, F f, const Range<T>& range) {
+    std::vector<T> samples (range.count());
+    if constexpr (batchSizeOf<F> > 0) {
+        tabulate<batchSizeOf<F>>(f, range.begin(), range.end(), samples.begin());
+    } else {
+        std::transform(range.begin(), range.end(), samples.begin(), f);
     }
+    return differentiate<DiffMethod, order>(policy, samples, range.step());
+}
 
-    std::vector<T> solution ( N );
-    for (ssize_t i = N - 1; i >= 0; --i) {
-        solution[i] = A.at(i, N) / A.at(i, i);
-        for (ssize_t k = i-1; k >= 0; --k) {
-            A.at(k, N) -= A.at(k, i) * solution[i];
-        }
+/**
+ * Differentiates function on all points of range sequentially.
+ */
+template <template <typename> typename DiffMethod, size_t order = 1, typename T, typename F>
+std::vector<T> differentiate(F f, const Range<T>& range) {
+    return differentiate<DiffMethod, order>(execution::seq, f, range);
+}
+
+/**
+ * Solves linear system given as augmented N x (N + 1) matrix [A | b].
+ *
+ * Solver is chosen by structure of A (see solveLinearSystem): banded systems, e.g. ones produced by Galerkin
+ * method with locally supported trial functions, are solved in band storage. To solve for many right-hand sides
+ * with the same matrix, use LUFactorization or BandLUFactorization directly.
+ *
+ * Singular systems are reported with an exception rather than inf or NaN in the solution, as was the case with
+ * naive Gaussian elimination used before: singularity is detected by an exactly zero pivot, so nearly singular
+ * systems still give an (inaccurate) solution.
+ * @param policy - execution policy used by the dense solver.
+ * @param A - augmented matrix [A | b] of N x (N + 1).
+ * @throws std::invalid_argument if A is not N x (N + 1).
+ * @throws std::runtime_error if A is singular.
+ */
+template <typename T, typename Policy, typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>>
+std::vector<T> eliminate(Policy policy, Surface<T>&& A) {
+    const size_t N = A.rowCount();
+    if (A.columnCount() != N + 1) {
+        throw std::invalid_argument("eliminate: augmented matrix should be N x (N + 1)");
     }
-    return solution;
+
+    std::vector<T> rhs (N);
+    for (size_t i = 0; i < N; ++i) {
+        rhs[i] = A.at(i, N);
+    }
+    const auto matrix = detail::stridedMatrix(std::as_const(A)).block(0, 0, N, N);
+    return detail::solveLinearSystem(policy, matrix, std::move(rhs));
+}
+
+/**
+ * Solves linear system given as augmented N x (N + 1) matrix [A | b] sequentially.
+ */
+template <typename T>
+std::vector<T> eliminate(Surface<T>&& A) {
+    return eliminate(execution::seq, std::move(A));
 }
 
 template <typename T, typename F>
@@ -315,29 +1320,284 @@ auto makeTrialFunction(std::vector<F> trials, std::vector<T> coefs) {
     };
 }
 
-template <template <typename> typename Stepper, size_t var = 0, typename T = double, typename DiffOp, typename F>
-auto galerkin(DiffOp LOp, std::vector<F> trials) {
-    return [=](Range<T> range) {
-        Surface<T> matrix (trials.size() - 1, trials.size());
-        for (size_t row = 0; row < matrix.rowCount(); ++row) {
-            auto phiK = trials[row];
-            // compute free coef
-            *(matrix.begin() + matrix.columnCount()*row + trials.size() - 1) =
-                -innerProduct<Stepper, var, T>(LOp(trials[0]), phiK)(range);
-            // compute other coefficents
-            std::transform(trials.begin() + 1, trials.end(), matrix.begin() + matrix.columnCount() * row,
-                               [phiK, range, LOp](auto phiJ) {
-                               return innerProduct<Stepper, var, T>(LOp(phiJ), phiK)(range);
-                           });
+/**
+ * Makes function sum(coefs[i] * phi_i) of basis functions phi_i, using the basis-specific evaluation scheme.
+ */
+template <typename Basis, typename T, typename = std::enable_if_t<isBasis<Basis>>>
+auto makeTrialFunction(const Basis& basis, std::vector<T> coefs) {
+    return basis.combination(std::move(coefs));
+}
+
+namespace detail {
+
+/**
+ * Number of quadrature nodes tabulated at once by assembleGalerkinTabulated.
+ */
+constexpr size_t galerkinBlockSize = 1 << 10;
+
+/**
+ * Converts matrix of all inner products gram(k, j) = <L(phi_j), phi_k> into Galerkin system.
+ */
+template <typename T>
+Surface<T> galerkinSystem(const Surface<T>& gram) {
+    const size_t N = gram.columnCount();
+    Surface<T> matrix (N - 1, N);
+    for (size_t k = 0; k < N - 1; ++k) {
+        for (size_t j = 1; j < N; ++j) {
+            matrix.at(k, j - 1) = gram.at(k, j);
         }
+        matrix.at(k, N - 1) = -gram.at(k, 0);
+    }
+    return matrix;
+}
+
+/**
+ * Trial functions for Galerkin method are given either as a vector of function objects, or as a basis
+ * (see Basis.hpp). These helpers provide uniform access to both.
+ */
+
+/**
+ * Writes values of all trials at x to out[0 .. trials.size()).
+ */
+template <typename X, typename Trials>
+inline void evalTrials(const Trials& trials, X x, X* out) {
+    if constexpr (isBasis<Trials>) {
+        trials.evalAll(x, out);
+    } else {
+        for (size_t i = 0; i < trials.size(); ++i) {
+            out[i] = trials[i](x);
+        }
+    }
+}
+
+/**
+ * Calls g(phi_i) for i-th trial function.
+ */
+template <typename Trials, typename G>
+inline void visitTrial(const Trials& trials, size_t i, G&& g) {
+    if constexpr (isFunctionBasis<Trials>) {
+        trials.visit(i, g);
+    } else {
+        g(trials[i]);
+    }
+}
+
+/**
+ * Applies LOp to every trial function: returns FunctionBasis for FunctionBasis, vector otherwise.
+ */
+template <typename Trials, typename DiffOp>
+auto mapTrials(const Trials& trials, const DiffOp& LOp) {
+    if constexpr (isFunctionBasis<Trials>) {
+        return trials.map(LOp);
+    } else {
+        std::vector<decltype(LOp(trials[0]))> mapped;
+        mapped.reserve(trials.size());
+        for (size_t i = 0; i < trials.size(); ++i) {
+            mapped.push_back(LOp(trials[i]));
+        }
+        return mapped;
+    }
+}
+
+/**
+ * Assembles Galerkin system, integrating every entry <L(phi_j), phi_k> separately over domain.
+ *
+ * With parallel policy, entries are handed out to threads one by one, so that expensive entries (high order
+ * functions, derivatives) do not leave other threads idle.
+ * @return Surface of (N - 1) x N: coefficients at phi_1 .. phi_{N-1} and the free term -<L(phi_0), phi_k>.
+ */
+template <template <typename> typename Stepper, size_t var, typename T,
+          typename Policy, typename DiffOp, typename Trials, typename Domain>
+Surface<T> assembleGalerkin(Policy policy, const DiffOp& LOp, const Trials& trials, const Domain& domain) {
+    const size_t N = trials.size();
+    Surface<T> gram (N - 1, N);
+    forEachIndex(policy, gram.size(), [&](size_t index) {
+        const size_t k = index / N, j = index % N;
+        visitTrial(trials, j, [&](const auto& phiJ) {
+            visitTrial(trials, k, [&](const auto& phiK) {
+                gram.at(k, j) = innerProduct<Stepper, var, T>(LOp(phiJ), phiK)(domain);
+            });
+        });
+    });
+    return galerkinSystem(gram);
+}
+
+template <template <typename> typename Stepper, size_t var, typename T, typename DiffOp, typename Trials, typename Domain>
+Surface<T> assembleGalerkin(const DiffOp& LOp, const Trials& trials, const Domain& domain) {
+    return assembleGalerkin<Stepper, var, T>(execution::seq, LOp, trials, domain);
+}
+
+/**
+ * Adds sum_m w_m phi_k(x_m) L(phi_j)(x_m) over nodes [first, last) of rule to gram(k, j).
+ *
+ * Nodes are processed in blocks of galerkinBlockSize: all phi_k (scaled by weights) and all L(phi_j) are evaluated
+ * once per node into rows of two block x N surfaces, and the block's contribution to all entries is the product
+ * of the first one (transposed) and the second one, computed with gemm.
+ */
+template <typename T, typename LTrials, typename Trials>
+void accumulateGram(Surface<T>& gram, const LTrials& LPhi, const Trials& trials,
+                    const QuadratureRule<T>& rule, size_t first, size_t last) {
+    const size_t N = trials.size();
+    // tables live in the thread's arena with padded rows, so repeated assembly does not allocate
+    ArenaScope scope;
+    auto phiTable = ArenaSurface<T>::padded(galerkinBlockSize, N);
+    auto LPhiTable = ArenaSurface<T>::padded(galerkinBlockSize, N);
+    const auto& nodes = rule.nodes();
+    const auto& weights = rule.weights();
+
+    for (; first < last; first += galerkinBlockSize) {
+        const size_t block = std::min(galerkinBlockSize, last - first);
+        for (size_t m = 0; m < block; ++m) {
+            T* phiRow = &phiTable.at(m, 0);
+            evalTrials(trials, nodes[first + m], phiRow);
+            for (size_t k = 0; k < N; ++k) {
+                phiRow[k] *= weights[first + m];
+            }
+            evalTrials(LPhi, nodes[first + m], &LPhiTable.at(m, 0));
+        }
+        const auto phiTransposed = phiTable.block(0, 0, block, N - 1).transposed();
+        const auto LPhiBlock = LPhiTable.block(0, 0, block, N);
+        gemm<execution::SequencedPolicy, T>(execution::seq, 1, phiTransposed, LPhiBlock, stridedMatrix(gram));
+    }
+}
+
+/**
+ * Assembles Galerkin system (same as assembleGalerkin) by tabulating functions on quadrature nodes.
+ *
+ * Takes O(N * M) function evaluations instead of O(N^2 * M), and memory does not depend on the number of nodes M.
+ * With parallel policy, nodes are split into chunks of integralChunkSize, each chunk accumulates its own matrix,
+ * and these are summed in chunk order, so results do not depend on the number of threads.
+ */
+template <typename T, typename Policy, typename DiffOp, typename Trials>
+Surface<T> assembleGalerkinTabulated(Policy, const DiffOp& LOp, const Trials& trials,
+                                     const QuadratureRule<T>& rule) {
+    const size_t N = trials.size();
+    const auto LPhi = mapTrials(trials, LOp);
+
+    Surface<T> gram (N - 1, N, static_cast<T>(0));
+    const size_t chunks = (rule.size() + integralChunkSize - 1) / integralChunkSize;
+    if (execution::isParallelPolicy<Policy> && chunks > 1) {
+        std::vector<Surface<T>> partials (chunks, gram);
+        parallelFor(chunks, [&](size_t chunk) {
+            const size_t first = chunk * integralChunkSize;
+            accumulateGram(partials[chunk], LPhi, trials, rule, first, std::min(first + integralChunkSize, rule.size()));
+        });
+        for (const auto& partial : partials) {
+            std::transform(gram.begin(), gram.end(), partial.begin(), gram.begin(), std::plus<T>());
+        }
+    } else {
+        accumulateGram(gram, LPhi, trials, rule, 0, rule.size());
+    }
+    return galerkinSystem(gram);
+}
+
+template <typename T, typename DiffOp, typename Trials>
+Surface<T> assembleGalerkinTabulated(const DiffOp& LOp, const Trials& trials, const QuadratureRule<T>& rule) {
+    return assembleGalerkinTabulated(execution::seq, LOp, trials, rule);
+}
+
+} // detail
+
+namespace detail {
+
+/**
+ * Galerkin method implementation: assembles and solves the system for trials (vector of functions or basis),
+ * makeSolution(coefs) then builds the approximate solution from coefficients of all trials.
+ */
+template <
+    template <typename> typename Stepper, size_t var, typename T,
+    typename Policy, typename DiffOp, typename Trials, typename MakeSolution
+>
+auto galerkin(Policy policy, DiffOp LOp, Trials trials, MakeSolution makeSolution) {
+    const auto solve = [=](Surface<T>&& matrix) {
         DEBUG_PRINT_SURFACE("Galerkin method -- out matrix", matrix);
-        auto trialCoefs = eliminate(std::move(matrix) );
+        auto trialCoefs = eliminate(policy, std::move(matrix));
         trialCoefs.insert(trialCoefs.begin(), 1.0); // todo optimize?
         DEBUG_PRINT_VECTOR("Trial coefs", trialCoefs);
-        return makeTrialFunction<T, F>(trials, trialCoefs);
+        return makeSolution(std::move(trialCoefs));
+    };
+    return [=](const auto& domain) {
+        using Domain = std::decay_t<decltype(domain)>;
+        if constexpr (std::is_same_v<Domain, QuadratureRule<T>>) {
+            return solve(detail::assembleGalerkinTabulated(policy, LOp, trials, domain));
+        } else if constexpr (hasFixedNodes<Stepper, T>) {
+            const auto rule = QuadratureRule<T>::template fromRange<Stepper>(Range<T> { domain });
+            return solve(detail::assembleGalerkinTabulated(policy, LOp, trials, rule));
+        } else {
+            return solve(detail::assembleGalerkin<Stepper, var, T>(policy, LOp, trials, domain));
+        }
     };
 }
 
+} // detail
+
+/**
+ * Solves L(y) = 0 approximately with Galerkin method: y = phi_0 + sum(c_j * phi_j), j >= 1.
+ *
+ * When quadrature nodes are known in advance (QuadratureRule is given, or Stepper has fixed nodes and Range is
+ * converted to a temporary rule), the system is assembled from tabulated function values
+ * (see detail::assembleGalerkinTabulated). Otherwise every entry is integrated separately with Stepper.
+ * To reuse a rule between calls, pass it explicitly, e.g. *QuadratureRuleCache<T>::instance().fromRange<...>(range).
+ * @tparam Stepper - stepper to use for computing inner products.
+ * @tparam var - index of integration variable.
+ * @tparam T - floating point type to use (usually deduced).
+ * @tparam Policy - execution policy type (usually deduced).
+ * @tparam DiffOp - type of differential operator (usually deduced).
+ * @tparam F - type of trial functions (usually deduced).
+ * @param policy - execution policy used to assemble the system, e.g. execution::par.
+ * @param LOp - differential operator: function object, which maps function to function.
+ * @param trials - trial functions.
+ * @return New function object, which takes either Range<T> or QuadratureRule<T> and returns approximate solution.
+ */
+template <
+    template <typename> typename Stepper, size_t var = 0, typename T = double,
+    typename Policy, typename DiffOp, typename F,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+auto galerkin(Policy policy, DiffOp LOp, std::vector<F> trials) {
+    return detail::galerkin<Stepper, var, T>(policy, LOp, trials, [trials](std::vector<T> coefs) {
+        return makeTrialFunction<T, F>(trials, std::move(coefs));
+    });
+}
+
+/**
+ * Solves L(y) = 0 approximately with Galerkin method, using functions of basis as trial functions.
+ *
+ * Same as the overload taking a vector of trials, but all basis functions are evaluated at once with
+ * basis.evalAll() during assembly, and the solution is evaluated with the basis-specific scheme (e.g. Clenshaw
+ * summation for ChebyshevBasis) instead of summing trial functions one by one. With FunctionBasis (see makeBasis)
+ * function types are known at compile time, so the assembly loop is inlined entirely.
+ */
+template <
+    template <typename> typename Stepper, size_t var = 0, typename T = double,
+    typename Policy, typename DiffOp, typename Basis,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy> && isBasis<Basis>>
+>
+auto galerkin(Policy policy, DiffOp LOp, const Basis& basis) {
+    return detail::galerkin<Stepper, var, T>(policy, LOp, basis, [basis](std::vector<T> coefs) {
+        return makeTrialFunction(basis, std::move(coefs));
+    });
+}
+
+/**
+ * Solves L(y) = 0 approximately with Galerkin method (see the overload with execution policy).
+ */
+template <template <typename> typename Stepper, size_t var = 0, typename T = double, typename DiffOp, typename F>
+auto galerkin(DiffOp LOp, std::vector<F> trials) {
+    return galerkin<Stepper, var, T>(execution::seq, LOp, trials);
+}
+
+/**
+ * Solves L(y) = 0 approximately with Galerkin method on basis (see the overload with execution policy).
+ */
+template <
+    template <typename> typename Stepper, size_t var = 0, typename T = double, typename DiffOp, typename Basis,
+    typename = std::enable_if_t<isBasis<Basis>>
+>
+auto galerkin(DiffOp LOp, const Basis& basis) {
+    return galerkin<Stepper, var, T>(execution::seq, LOp, basis);
+}
+
 /**
  * Generates polynomial (f0(x) = x^0, f1(x) = x^1, f2(x) = x^2 ...) functions.
  * @tparam T type of argument and return type
@@ -345,35 +1605,35 @@ auto galerkin(DiffOp LOp, std::vector<F> trials) {
  * @return vector of generated functions
  *
  * maxOrder defines power of highest-order polynomial. e.g., for maxOrder == 4, five polynomials will be generated, first f0(x) == 1, last f4(x) == x^4
+ * To evaluate the whole basis at once, or a linear combination with Horner scheme, use PolynomialBasis.
  */
 template <typename T = double>
 auto polynomials(size_t maxOrder) {
-    std::vector<std::function<T(T)>> fns { [](T) { return static_cast<T>(1); } };
-    fns.reserve((maxOrder + 1));
-    for (size_t i = 1; i <= maxOrder; ++i) {
-        fns.emplace_back( [i](T x) { return std::pow(x, i); } );
+    std::vector<std::function<T(T)>> fns;
+    fns.reserve(maxOrder + 1);
+    for (const auto& monomial : PolynomialBasis<T>(maxOrder).functions()) {
+        fns.emplace_back(monomial);
     }
     return fns;
 }
 
+/**
+ * Generates Chebyshev polynomials of the first kind T_0 .. T_maxOrder.
+ *
+ * Every function evaluates its polynomial with the three-term recurrence in O(order); to evaluate all of them at
+ * once, or their linear combination, use ChebyshevBasis.
+ * @param maxOrder maximal order of polynomial.
+ * @return vector of generated functions
+ */
 template <typename T = double, typename Fun = std::function<T(T)>, typename FunVec = std::vector<Fun>>
 auto chebyshevPolynomials(size_t maxOrder) -> FunVec {
-    Fun Tnm1 = [](T) { return static_cast<T>(1); };
-    if (maxOrder == 0) {
-        return { Tnm1 };
-    }
-    Fun Tn = [](T x) { return x; };
-    if (maxOrder == 1) {
-        return { Tnm1, Tn };
-    }
-    FunVec fns { Tnm1 };
+    FunVec fns;
     fns.reserve(maxOrder + 1);
-    for (size_t i = 1; i <= maxOrder; ++i) {
-        fns.emplace_back(Tn);
-        std::tie(Tn, Tnm1) = std::pair { [Tn, Tnm1,i](T x) {  return 2.0*x*Tn(x) - Tnm1(x); }, Tn };
+    for (const auto& polynomial : ChebyshevBasis<T>(maxOrder).functions()) {
+        fns.emplace_back(polynomial);
     }
     return fns;
-};
+}
 
 } // nya
 
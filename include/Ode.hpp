@@ -0,0 +1,585 @@
+#ifndef NUMUTILS_ODE_HPP
+#define NUMUTILS_ODE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "PrecisionTraits.hpp"
+
+namespace nya {
+
+/**
+ * Initial value problems y' = f(t, y), y(t0) = y0.
+ *
+ * State y is either a scalar (float, double) or a contiguous container of them (std::array, std::vector, ...).
+ * System f is a function object, called either as f(t, y, dydt) (writes derivative to dydt) or as dydt = f(t, y).
+ * For dynamically sized states, the first form should be used: all buffers of Solver are allocated when it is
+ * constructed, so that stepping performs no heap allocations.
+ */
+namespace ode {
+
+namespace detail {
+
+template <typename State, typename = void>
+struct StateValueOf {
+    using type = State;
+};
+
+template <typename State>
+struct StateValueOf<State, std::void_t<typename State::value_type>> {
+    using type = typename State::value_type;
+};
+
+/**
+ * Floating point type of elements of State.
+ */
+template <typename State>
+using StateValue = typename StateValueOf<State>::type;
+
+template <typename State>
+inline auto* stateData(State& y) noexcept {
+    if constexpr (std::is_arithmetic_v<std::remove_const_t<State>>) {
+        return &y;
+    } else {
+        return y.data();
+    }
+}
+
+template <typename State>
+inline size_t stateSize(const State& y) noexcept {
+    if constexpr (std::is_arithmetic_v<State>) {
+        return 1;
+    } else {
+        return y.size();
+    }
+}
+
+template <typename System, typename T, typename State>
+inline void evalSystem(const System& f, T t, const State& y, State& dydt) {
+    if constexpr (std::is_invocable_v<const System&, T, const State&, State&>) {
+        f(t, y, dydt);
+    } else {
+        dydt = f(t, y);
+    }
+}
+
+/**
+ * out[i] = y[i] + h * sum(coefs[j] * k[j][i]), j < terms.
+ */
+template <typename T, size_t S>
+inline void combine(T* out, const T* y, T h, const T (&coefs)[S], const std::array<const T*, S>& k,
+                    size_t terms, size_t count) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        T sum = 0;
+        for (size_t j = 0; j < terms; ++j) {
+            sum += coefs[j] * k[j][i];
+        }
+        out[i] = y[i] + h * sum;
+    }
+}
+
+/**
+ * Classic 4th order Runge-Kutta method.
+ */
+template <typename T>
+struct RK4Tableau {
+    static constexpr size_t stages = 4;
+    static constexpr size_t order = 4;
+    static constexpr size_t errorOrder = 4;
+    static constexpr bool fsal = false;
+    static constexpr bool embedded = false;
+    static constexpr bool dense = false;
+
+    static constexpr T c[stages] = { 0, T(1) / 2, T(1) / 2, 1 };
+    static constexpr T a[stages][stages] = {
+        {},
+        { T(1) / 2 },
+        { 0, T(1) / 2 },
+        { 0, 0, 1 },
+    };
+    static constexpr T b[stages] = { T(1) / 6, T(1) / 3, T(1) / 3, T(1) / 6 };
+};
+
+/**
+ * Runge-Kutta-Fehlberg 4(5) method; the 5th order solution is propagated (local extrapolation).
+ */
+template <typename T>
+struct RKF45Tableau {
+    static constexpr size_t stages = 6;
+    static constexpr size_t order = 5;
+    static constexpr size_t errorOrder = 4;
+    static constexpr bool fsal = false;
+    static constexpr bool embedded = true;
+    static constexpr bool dense = false;
+
+    static constexpr T c[stages] = { 0, T(1) / 4, T(3) / 8, T(12) / 13, 1, T(1) / 2 };
+    static constexpr T a[stages][stages] = {
+        {},
+        { T(1) / 4 },
+        { T(3) / 32, T(9) / 32 },
+        { T(1932) / 2197, T(-7200) / 2197, T(7296) / 2197 },
+        { T(439) / 216, -8, T(3680) / 513, T(-845) / 4104 },
+        { T(-8) / 27, 2, T(-3544) / 2565, T(1859) / 4104, T(-11) / 40 },
+    };
+    static constexpr T b[stages] = {
+        T(16) / 135, 0, T(6656) / 12825, T(28561) / 56430, T(-9) / 50, T(2) / 55
+    };
+    /**
+     * Difference of 5th and 4th order weights.
+     */
+    static constexpr T e[stages] = {
+        T(1) / 360, 0, T(-128) / 4275, T(-2197) / 75240, T(1) / 50, T(2) / 55
+    };
+};
+
+/**
+ * Dormand-Prince 5(4) method (DOPRI5) with 4th order dense output of Hairer, Norsett and Wanner.
+ */
+template <typename T>
+struct DormandPrinceTableau {
+    static constexpr size_t stages = 7;
+    static constexpr size_t order = 5;
+    static constexpr size_t errorOrder = 4;
+    static constexpr bool fsal = true;
+    static constexpr bool embedded = true;
+    static constexpr bool dense = true;
+
+    static constexpr T c[stages] = { 0, T(1) / 5, T(3) / 10, T(4) / 5, T(8) / 9, 1, 1 };
+    static constexpr T a[stages][stages] = {
+        {},
+        { T(1) / 5 },
+        { T(3) / 40, T(9) / 40 },
+        { T(44) / 45, T(-56) / 15, T(32) / 9 },
+        { T(19372) / 6561, T(-25360) / 2187, T(64448) / 6561, T(-212) / 729 },
+        { T(9017) / 3168, T(-355) / 33, T(46732) / 5247, T(49) / 176, T(-5103) / 18656 },
+        { T(35) / 384, 0, T(500) / 1113, T(125) / 192, T(-2187) / 6784, T(11) / 84 },
+    };
+    static constexpr T b[stages] = {
+        T(35) / 384, 0, T(500) / 1113, T(125) / 192, T(-2187) / 6784, T(11) / 84, 0
+    };
+    /**
+     * Difference of 5th and 4th order weights.
+     */
+    static constexpr T e[stages] = {
+        T(71) / 57600, 0, T(-71) / 16695, T(71) / 1920, T(-17253) / 339200, T(22) / 525, T(-1) / 40
+    };
+    /**
+     * Coefficients of the dense output polynomial.
+     */
+    static constexpr T d[stages] = {
+        T(-12715105075.0L / 11282082432.0L), 0, T(87487479700.0L / 32700410799.0L),
+        T(-10690763975.0L / 1880347072.0L), T(701980252875.0L / 199316789632.0L),
+        T(-1453857185.0L / 822651844.0L), T(69997945.0L / 29380423.0L)
+    };
+};
+
+/**
+ * Explicit Runge-Kutta stepper, defined by Butcher tableau.
+ *
+ * Stage derivatives are kept in buffers allocated on construction. The derivative at the beginning of the step
+ * is passed in, and the derivative at its end is computed (for FSAL tableaus it is the last stage), so every
+ * accepted step starts with a known derivative.
+ * @tparam State - type of state.
+ * @tparam Tableau - coefficients of the method.
+ */
+template <typename State, typename Tableau>
+class ExplicitRungeKutta {
+public:
+    using T = StateValue<State>;
+
+    static constexpr size_t stages = Tableau::stages;
+    static constexpr size_t order = Tableau::order;
+    /**
+     * Order of the error estimate, which determines step size control.
+     */
+    static constexpr size_t errorOrder = Tableau::errorOrder;
+    static constexpr bool adaptive = Tableau::embedded;
+    /**
+     * Number of evaluations of system per step (excluding the derivative at the beginning).
+     */
+    static constexpr size_t evaluationsPerStep = Tableau::fsal ? stages - 1 : stages;
+
+    explicit ExplicitRungeKutta(const State& like) : stage_(like) {
+        k_.fill(like);
+    }
+
+    /**
+     * Makes step of size h from (t, y), where dydt = f(t, y). Writes solution to yNew and f(t + h, yNew) to dydtNew.
+     */
+    template <typename System>
+    void step(const System& f, T t, T h, const State& y, const State& dydt, State& yNew, State& dydtNew) {
+        const size_t n = stateSize(y);
+        std::array<const T*, stages> k;
+        k[0] = stateData(dydt);
+        for (size_t s = 1; s < stages; ++s) {
+            const bool last = Tableau::fsal && s == stages - 1;
+            State& stageState = last ? yNew : stage_;
+            State& stageDerivative = last ? dydtNew : k_[s - 1];
+            combine(stateData(stageState), stateData(y), h, Tableau::a[s], k, s, n);
+            evalSystem(f, t + Tableau::c[s] * h, stageState, stageDerivative);
+            k[s] = stateData(stageDerivative);
+        }
+        if constexpr (!Tableau::fsal) {
+            combine(stateData(yNew), stateData(y), h, Tableau::b, k, stages, n);
+            evalSystem(f, t + h, yNew, dydtNew);
+        }
+    }
+
+    /**
+     * Estimates error of the last step: root mean square of the embedded error estimate,
+     * scaled by absTol + relTol * max(|y|, |yNew|). The step is acceptable if result is not greater than 1.
+     */
+    T error(T h, const State& y, const State& dydt, const State& yNew, const State& dydtNew,
+            T absTol, T relTol) const noexcept {
+        static_assert(adaptive, "Stepper has no error estimate");
+        const auto k = stageDerivatives(dydt, dydtNew);
+        const T* y0 = stateData(y);
+        const T* y1 = stateData(yNew);
+        const size_t n = stateSize(y);
+        T sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            T e = 0;
+            for (size_t j = 0; j < stages; ++j) {
+                e += Tableau::e[j] * k[j][i];
+            }
+            const T scaled = h * e / (absTol + relTol * std::max(std::abs(y0[i]), std::abs(y1[i])));
+            sum += scaled * scaled;
+        }
+        return std::sqrt(sum / n);
+    }
+
+    /**
+     * Dense output: writes solution at t + theta*h, 0 <= theta <= 1, of the last step to out.
+     *
+     * Uses dense output polynomial of the method if it has one, and cubic Hermite interpolation otherwise.
+     */
+    void interpolate(T theta, T h, const State& y, const State& dydt, const State& yNew, const State& dydtNew,
+                     State& out) const noexcept {
+        const T* y0 = stateData(y);
+        const T* y1 = stateData(yNew);
+        const T* f0 = stateData(dydt);
+        const T* f1 = stateData(dydtNew);
+        T* result = stateData(out);
+        const size_t n = stateSize(y);
+        if constexpr (Tableau::dense) {
+            const auto k = stageDerivatives(dydt, dydtNew);
+            for (size_t i = 0; i < n; ++i) {
+                T r5 = 0;
+                for (size_t j = 0; j < stages; ++j) {
+                    r5 += Tableau::d[j] * k[j][i];
+                }
+                const T r2 = y1[i] - y0[i];
+                const T r3 = h * f0[i] - r2;
+                const T r4 = r2 - h * f1[i] - r3;
+                result[i] = y0[i] + theta * (r2 + (1 - theta) * (r3 + theta * (r4 + (1 - theta) * h * r5)));
+            }
+        } else {
+            const T theta2 = theta * theta, theta3 = theta2 * theta;
+            const T h00 = 2 * theta3 - 3 * theta2 + 1;
+            const T h10 = theta3 - 2 * theta2 + theta;
+            const T h01 = 3 * theta2 - 2 * theta3;
+            const T h11 = theta3 - theta2;
+            for (size_t i = 0; i < n; ++i) {
+                result[i] = h00 * y0[i] + h10 * h * f0[i] + h01 * y1[i] + h11 * h * f1[i];
+            }
+        }
+    }
+
+private:
+    State stage_;
+    std::array<State, stages - 1> k_;
+
+    std::array<const T*, stages> stageDerivatives(const State& dydt, const State& dydtNew) const noexcept {
+        std::array<const T*, stages> k;
+        k[0] = stateData(dydt);
+        for (size_t s = 1; s < stages; ++s) {
+            k[s] = stateData(k_[s - 1]);
+        }
+        if constexpr (Tableau::fsal) {
+            k[stages - 1] = stateData(dydtNew);
+        }
+        return k;
+    }
+};
+
+} // detail
+
+/**
+ * Classic 4th order Runge-Kutta stepper with fixed step size.
+ * @tparam State - type of state (usually deduced).
+ */
+template <typename State>
+using RK4 = detail::ExplicitRungeKutta<State, detail::RK4Tableau<detail::StateValue<State>>>;
+
+/**
+ * Adaptive Runge-Kutta-Fehlberg 4(5) stepper; dense output is cubic Hermite interpolation.
+ * @tparam State - type of state (usually deduced).
+ */
+template <typename State>
+using RKF45 = detail::ExplicitRungeKutta<State, detail::RKF45Tableau<detail::StateValue<State>>>;
+
+/**
+ * Adaptive Dormand-Prince 5(4) stepper with 4th order dense output.
+ * @tparam State - type of state (usually deduced).
+ */
+template <typename State>
+using DormandPrince = detail::ExplicitRungeKutta<State, detail::DormandPrinceTableau<detail::StateValue<State>>>;
+
+/**
+ * Parameters of Solver.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+struct Options {
+    /**
+     * Absolute and relative tolerances of a single step (adaptive steppers only).
+     */
+    T absTol = PrecisionTraits<T>::odeTolerance();
+    T relTol = PrecisionTraits<T>::odeTolerance();
+    /**
+     * Step size of fixed step steppers, or the first step size of adaptive ones (0 to estimate it automatically).
+     */
+    T initialStep = 0;
+    T maxStep = std::numeric_limits<T>::infinity();
+};
+
+/**
+ * Solves initial value problem y' = f(t, y), y(t0) = y0, one step at a time, forward in t.
+ *
+ * All buffers are allocated on construction, so neither step() nor advanceTo() allocate memory (as long as
+ * f itself does not, see above).
+ * @tparam Stepper - ODE stepper, e.g. RK4, RKF45 or DormandPrince.
+ * @tparam State - type of state.
+ * @tparam System - type of function object f.
+ */
+template <template <typename> typename Stepper, typename State, typename System>
+class Solver {
+public:
+    using T = detail::StateValue<State>;
+
+    Solver(System f, T t0, State y0, Options<T> options = {})
+        : f_(std::move(f)), options_(options), stepper_(y0), t_(t0), tPrevious_(t0),
+          y_(std::move(y0)), yPrevious_(y_), dydt_(y_), dydtPrevious_(y_), out_(y_) {
+        detail::evalSystem(f_, t_, y_, dydt_);
+        evaluations_ = 1;
+        if (options_.initialStep > 0) {
+            h_ = std::min(options_.initialStep, options_.maxStep);
+        } else if constexpr (Stepper<State>::adaptive) {
+            h_ = estimateInitialStep();
+        } else {
+            throw std::invalid_argument("Fixed step size stepper requires options.initialStep");
+        }
+    }
+
+    inline T time() const noexcept {
+        return t_;
+    }
+
+    inline const State& state() const noexcept {
+        return y_;
+    }
+
+    /**
+     * @brief Returns f(time(), state()).
+     */
+    inline const State& derivative() const noexcept {
+        return dydt_;
+    }
+
+    /**
+     * @brief Returns size of the next step to try.
+     */
+    inline T stepSize() const noexcept {
+        return h_;
+    }
+
+    inline size_t steps() const noexcept {
+        return steps_;
+    }
+
+    inline size_t rejectedSteps() const noexcept {
+        return rejected_;
+    }
+
+    inline size_t evaluations() const noexcept {
+        return evaluations_;
+    }
+
+    /**
+     * Makes one accepted step. Adaptive steppers retry rejected steps with smaller step size.
+     * @throws std::runtime_error if step size becomes too small for time() to advance.
+     */
+    void step() {
+        bool rejected = false;
+        for (;;) {
+            const T h = std::min(h_, options_.maxStep);
+            stepper_.step(f_, t_, h, y_, dydt_, yPrevious_, dydtPrevious_);
+            evaluations_ += Stepper<State>::evaluationsPerStep;
+            if constexpr (Stepper<State>::adaptive) {
+                constexpr T safety = T(0.9), minFactor = T(0.2), maxFactor = 5;
+                constexpr T exponent = T(-1) / (Stepper<State>::errorOrder + 1);
+                const T error = stepper_.error(h, y_, dydt_, yPrevious_, dydtPrevious_,
+                                               options_.absTol, options_.relTol);
+                if (!(error <= 1)) { // NaN is rejected as well
+                    ++rejected_;
+                    rejected = true;
+                    const T factor = std::isfinite(error) ? safety * std::pow(error, exponent) : minFactor;
+                    h_ = h * std::max(minFactor, factor);
+                    if (!(t_ + h_ > t_)) {
+                        throw std::runtime_error("ODE step size underflow");
+                    }
+                    continue;
+                }
+                T factor = error > 0 ? std::min(maxFactor, safety * std::pow(error, exponent)) : maxFactor;
+                if (rejected) {
+                    factor = std::min(factor, T(1));
+                }
+                h_ = h * factor;
+            }
+            tPrevious_ = t_;
+            t_ += h;
+            hLast_ = h;
+            std::swap(y_, yPrevious_);
+            std::swap(dydt_, dydtPrevious_);
+            ++steps_;
+            return;
+        }
+    }
+
+    /**
+     * Steps until time() >= t, and returns solution at t, obtained with dense output of the last step.
+     *
+     * The returned reference is valid until the next call of advanceTo().
+     * @throws std::invalid_argument if t is before the last step.
+     */
+    const State& advanceTo(T t) {
+        while (t_ < t) {
+            step();
+        }
+        interpolate(t, out_);
+        return out_;
+    }
+
+    /**
+     * Writes solution at t, which lies within the last step, to out.
+     * @throws std::invalid_argument if t is outside of the last step.
+     */
+    void interpolate(T t, State& out) const {
+        if (t < tPrevious_ || t > t_) {
+            throw std::invalid_argument("Time is outside of the last step");
+        }
+        if (t == t_) {
+            out = y_;
+        } else if (t == tPrevious_) {
+            out = yPrevious_;
+        } else {
+            if constexpr (!std::is_arithmetic_v<State>) {
+                if (out.size() != y_.size()) {
+                    out = y_;
+                }
+            }
+            stepper_.interpolate((t - tPrevious_) / hLast_, hLast_, yPrevious_, dydtPrevious_, y_, dydt_, out);
+        }
+    }
+
+private:
+    System f_;
+    Options<T> options_;
+    Stepper<State> stepper_;
+    T t_, tPrevious_;
+    T h_ = 0, hLast_ = 0;
+    State y_, yPrevious_, dydt_, dydtPrevious_, out_;
+    size_t steps_ = 0, rejected_ = 0, evaluations_ = 0;
+
+    /**
+     * Initial step size heuristic of Hairer, Norsett and Wanner (Solving ODE I, II.4).
+     */
+    T estimateInitialStep() {
+        const size_t n = detail::stateSize(y_);
+        const T* y = detail::stateData(y_);
+        const T* f0 = detail::stateData(dydt_);
+        const auto scale = [&](size_t i) { return options_.absTol + options_.relTol * std::abs(y[i]); };
+
+        T d0 = 0, d1 = 0;
+        for (size_t i = 0; i < n; ++i) {
+            d0 += (y[i] / scale(i)) * (y[i] / scale(i));
+            d1 += (f0[i] / scale(i)) * (f0[i] / scale(i));
+        }
+        d0 = std::sqrt(d0 / n);
+        d1 = std::sqrt(d1 / n);
+        const T h0 = d0 < T(1e-5) || d1 < T(1e-5) ? T(1e-6) : T(0.01) * d0 / d1;
+
+        T* y1 = detail::stateData(yPrevious_);
+        for (size_t i = 0; i < n; ++i) {
+            y1[i] = y[i] + h0 * f0[i];
+        }
+        detail::evalSystem(f_, t_ + h0, yPrevious_, dydtPrevious_);
+        ++evaluations_;
+        const T* f1 = detail::stateData(dydtPrevious_);
+        T d2 = 0;
+        for (size_t i = 0; i < n; ++i) {
+            d2 += ((f1[i] - f0[i]) / scale(i)) * ((f1[i] - f0[i]) / scale(i));
+        }
+        d2 = std::sqrt(d2 / n) / h0;
+
+        const T dMax = std::max(d1, d2);
+        const T h1 = dMax <= T(1e-15) ? std::max(T(1e-6), h0 * T(1e-3))
+                                     : std::pow(T(0.01) / dMax, T(1) / (Stepper<State>::order + 1));
+        return std::min({ 100 * h0, h1, options_.maxStep });
+    }
+};
+
+/**
+ * Makes Solver for y' = f(t, y), y(t0) = y0.
+ * @tparam Stepper - ODE stepper, e.g. RK4, RKF45 or DormandPrince.
+ */
+template <template <typename> typename Stepper = DormandPrince, typename System, typename State>
+auto makeSolver(System f, detail::StateValue<State> t0, State y0,
+                Options<detail::StateValue<State>> options = {}) {
+    return Solver<Stepper, State, System> { std::move(f), t0, std::move(y0), options };
+}
+
+/**
+ * Solves y' = f(t, y), y(t0) = y0 on [t0, t1].
+ * @tparam Stepper - ODE stepper, e.g. RK4, RKF45 or DormandPrince.
+ * @param observe - function object, called as observe(t, y) at t0, at the end of every step before t1, and at t1.
+ * @return y(t1).
+ */
+template <template <typename> typename Stepper = DormandPrince, typename System, typename State, typename Observer>
+State solve(System f, detail::StateValue<State> t0, State y0, detail::StateValue<State> t1, Observer observe,
+            Options<detail::StateValue<State>> options = {}) {
+    auto solver = makeSolver<Stepper>(std::move(f), t0, std::move(y0), options);
+    observe(solver.time(), solver.state());
+    while (solver.time() < t1) {
+        solver.step();
+        if (solver.time() < t1) {
+            observe(solver.time(), solver.state());
+        }
+    }
+    const State& y1 = solver.advanceTo(t1);
+    observe(t1, y1);
+    return y1;
+}
+
+/**
+ * Solves y' = f(t, y), y(t0) = y0 on [t0, t1].
+ * @tparam Stepper - ODE stepper, e.g. RK4, RKF45 or DormandPrince.
+ * @return y(t1).
+ */
+template <template <typename> typename Stepper = DormandPrince, typename System, typename State>
+State solve(System f, detail::StateValue<State> t0, State y0, detail::StateValue<State> t1,
+            Options<detail::StateValue<State>> options = {}) {
+    return solve<Stepper>(std::move(f), t0, std::move(y0), t1, [](auto, const auto&) {}, options);
+}
+
+} // ode
+
+} // nya
+
+#endif //NUMUTILS_ODE_HPP
@@ -2,13 +2,32 @@
 #define NUMUTILS_PRECISIONTRAITS_HPP
 
 #include <cfenv>
+#include <cmath>
+#include <cstddef>
+#include <limits>
 
 namespace nya {
 
 template< typename T >
 struct PrecisionTraitsBase {
+    /**
+     * Cheaper floating point type to factor matrices in for mixed-precision iterative refinement (see
+     * RefinedLUFactorization); T itself, if there is none.
+     */
+    using Reduced = T;
+    /**
+     * Machine epsilon (std::numeric_limits is not specialized for every extended type).
+     */
+    constexpr static T epsilon();
     constexpr static T derivativePrecision(size_t order);
     constexpr static T derivativeError();
+    /**
+     * Step of finite differences: truncation error O(h^accuracy) and rounding error O(eps / h^order) are balanced
+     * at h ~ eps^(1 / (order + accuracy)).
+     */
+    static T derivativeStep(size_t order, size_t accuracy);
+    constexpr static T quadratureTolerance();
+    constexpr static T odeTolerance();
 };
 
 template< typename T >
@@ -17,18 +36,90 @@ struct PrecisionTraits : PrecisionTraitsBase<T> {
 
 template<>
 struct PrecisionTraits<double> {
+    using Reduced = float;
+
+    constexpr static double epsilon() { return std::numeric_limits<double>::epsilon(); }
+
     constexpr static double derivativePrecision(size_t order) { return 1e-10; }
 
+    static double derivativeStep(size_t order, size_t accuracy) {
+        return std::pow(std::numeric_limits<double>::epsilon(), 1.0 / (order + accuracy));
+    }
+
     constexpr static double derivativeError() { return 1e-6; }
+
+    constexpr static double quadratureTolerance() { return 1e-10; }
+
+    constexpr static double odeTolerance() { return 1e-8; }
 };
 
 template<>
 struct PrecisionTraits<float> {
+    using Reduced = float;
+
+    constexpr static float epsilon() { return std::numeric_limits<float>::epsilon(); }
+
     constexpr static float derivativePrecision(size_t order) { return 1e-6f; }
 
+    static float derivativeStep(size_t order, size_t accuracy) {
+        return std::pow(std::numeric_limits<float>::epsilon(), 1.0f / (order + accuracy));
+    }
+
     constexpr static float derivativeError() { return 1e-3; }
+
+    constexpr static float quadratureTolerance() { return 1e-5f; }
+
+    constexpr static float odeTolerance() { return 1e-4f; }
+};
+
+template<>
+struct PrecisionTraits<long double> {
+    using Reduced = double;
+
+    constexpr static long double epsilon() { return std::numeric_limits<long double>::epsilon(); }
+
+    constexpr static long double derivativePrecision(size_t) { return 1e-12L; }
+
+    static long double derivativeStep(size_t order, size_t accuracy) {
+        return std::pow(std::numeric_limits<long double>::epsilon(), 1.0L / (order + accuracy));
+    }
+
+    constexpr static long double derivativeError() { return 1e-8L; }
+
+    constexpr static long double quadratureTolerance() { return 1e-13L; }
+
+    constexpr static long double odeTolerance() { return 1e-10L; }
 };
 
+#if defined(__SIZEOF_FLOAT128__) && !defined(__STRICT_ANSI__)
+#define NUMUTILS_HAS_FLOAT128 1
+
+/**
+ * Quadruple precision (GCC/Clang extension, available with GNU dialect, e.g. -std=gnu++17). Arithmetic is done
+ * in software, so it is mostly useful for residuals and accumulation, with heavy work done in double.
+ */
+template<>
+struct PrecisionTraits<__float128> {
+    using Reduced = double;
+
+    constexpr static __float128 epsilon() { return 0x1p-112Q; }
+
+    constexpr static __float128 derivativePrecision(size_t) { return 1e-16; }
+
+    static __float128 derivativeStep(size_t order, size_t accuracy) {
+        // <cmath> has no __float128 overloads, the step is only needed approximately
+        return std::pow(static_cast<long double>(epsilon()), 1.0L / (order + accuracy));
+    }
+
+    constexpr static __float128 derivativeError() { return 1e-12; }
+
+    constexpr static __float128 quadratureTolerance() { return 1e-20; }
+
+    constexpr static __float128 odeTolerance() { return 1e-16; }
+};
+
+#endif
+
 }
 
 #endif //NUMUTILS_PRECISIONTRAITS_HPP
@@ -0,0 +1,605 @@
+#ifndef NUMUTILS_QUADRATURE_HPP
+#define NUMUTILS_QUADRATURE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+#include "Batch.hpp"
+#include "Range.hpp"
+#include "Summation.hpp"
+
+namespace nya {
+
+/**
+ * Result of a single application of quadrature rule to an interval.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+struct QuadratureEstimate {
+    T value;
+    T error;
+};
+
+/**
+ * Result of adaptive integration.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+struct QuadratureResult {
+    T value;
+    /**
+     * Estimated absolute error.
+     */
+    T error;
+    /**
+     * Number of function evaluations used.
+     */
+    size_t evaluations;
+    /**
+     * Number of subintervals in the final partition.
+     */
+    size_t intervals;
+    /**
+     * Whether requested tolerance was reached before running out of subintervals.
+     */
+    bool converged;
+
+    inline operator T() const noexcept {
+        return value;
+    }
+};
+
+/**
+ * 21-point Gauss-Kronrod rule (with embedded 10-point Gauss rule for error estimation).
+ *
+ * Can be used either as an integral stepper (integral<GK21>, applies the rule to every cell of the range),
+ * or as a rule of adaptiveIntegral. Nodes and weights are taken from QUADPACK (qk21).
+ * @tparam T - floating point type to use (usually deduced)
+ */
+template <typename T>
+struct GK21 {
+    static constexpr size_t points = 21;
+
+    /**
+     * Kronrod nodes on [0, 1] (the rule is symmetric); odd ones are nodes of the Gauss rule.
+     */
+    static constexpr T nodes[11] = {
+        0.995657163025808080735527280689003, 0.973906528517171720077964012084452,
+        0.930157491355708226001207180059508, 0.865063366688984510732096688423493,
+        0.780817726586416897063717578345042, 0.679409568299024406234327365114874,
+        0.562757134668604683339000099272694, 0.433395394129247190799265943165784,
+        0.294392862701460198131126603103866, 0.148874338981631210884826001129720,
+        0.000000000000000000000000000000000,
+    };
+
+    static constexpr T kronrodWeights[11] = {
+        0.011694638867371874278064396062192, 0.032558162307964727478818972459390,
+        0.054755896574351996031381300244580, 0.075039674810919952767043140916190,
+        0.093125454583697605535065465083366, 0.109387158802297641899210590325805,
+        0.123491976262065851077600525452184, 0.134709217311473325928054001771707,
+        0.142775938577060080797094273138717, 0.147739104901338491374841515972068,
+        0.149445554002916905664936468389821,
+    };
+
+    static constexpr T gaussWeights[5] = {
+        0.066671344308688137593568809893332, 0.149451349150580593145776339657697,
+        0.219086362515982043995534934228163, 0.269266719309996355091226921569469,
+        0.295524224714752870173892994651338,
+    };
+
+    /**
+     * Applies the rule to [a, b].
+     * @return Kronrod estimate of the integral and its error, estimated QUADPACK-style from difference with Gauss one.
+     */
+    template <typename F>
+    QuadratureEstimate<T> estimate(const F& f, T a, T b) const {
+        const T center = (a + b) / 2;
+        const T halfLength = (b - a) / 2;
+
+        T values[21];
+        values[20] = f(center);
+        for (size_t i = 0; i < 10; ++i) {
+            values[2*i]     = f(center - halfLength * nodes[i]);
+            values[2*i + 1] = f(center + halfLength * nodes[i]);
+        }
+
+        T kronrod = kronrodWeights[10] * values[20];
+        T gauss = 0;
+        T absolute = std::abs(kronrod);
+        for (size_t i = 0; i < 10; ++i) {
+            const T pair = values[2*i] + values[2*i + 1];
+            kronrod += kronrodWeights[i] * pair;
+            absolute += kronrodWeights[i] * (std::abs(values[2*i]) + std::abs(values[2*i + 1]));
+            if (i % 2 == 1) {
+                gauss += gaussWeights[i / 2] * pair;
+            }
+        }
+
+        const T mean = kronrod / 2;
+        T deviation = kronrodWeights[10] * std::abs(values[20] - mean);
+        for (size_t i = 0; i < 10; ++i) {
+            deviation += kronrodWeights[i] * (std::abs(values[2*i] - mean) + std::abs(values[2*i + 1] - mean));
+        }
+
+        const T scale = std::abs(halfLength);
+        T error = std::abs((kronrod - gauss) * halfLength);
+        deviation *= scale;
+        absolute *= scale;
+        if (deviation != 0 && error != 0) {
+            error = deviation * std::min(static_cast<T>(1), std::pow(200 * error / deviation, static_cast<T>(1.5)));
+        }
+        if (absolute > std::numeric_limits<T>::min() / (50 * std::numeric_limits<T>::epsilon())) {
+            error = std::max(50 * std::numeric_limits<T>::epsilon() * absolute, error);
+        }
+        return { kronrod * halfLength, error };
+    }
+
+    /**
+     * Integral stepper interface: integrates f over the cell [x, x + h].
+     */
+    template <typename F, typename X>
+    auto operator()(const F& f, T h, X x) const {
+        const auto center = x + h / 2;
+        auto sum = kronrodWeights[10] * f(center);
+        for (size_t i = 0; i < 10; ++i) {
+            sum = sum + kronrodWeights[i] * (f(center - h / 2 * nodes[i]) + f(center + h / 2 * nodes[i]));
+        }
+        return h / 2 * sum;
+    }
+
+    /**
+     * Fixed nodes interface: calls emit(node, weight) for every node of the rule on the cell [x, x + h].
+     */
+    template <typename Emit>
+    void cellNodes(T h, T x, Emit&& emit) const {
+        const T center = x + h / 2;
+        for (size_t i = 0; i < 10; ++i) {
+            emit(center - h / 2 * nodes[i], h / 2 * kronrodWeights[i]);
+        }
+        emit(center, h / 2 * kronrodWeights[10]);
+        for (size_t i = 10; i-- > 0;) {
+            emit(center + h / 2 * nodes[i], h / 2 * kronrodWeights[i]);
+        }
+    }
+};
+
+namespace detail {
+
+template <typename T>
+struct NodeSink {
+    void operator()(T, T) const {}
+};
+
+template <typename Stepper, typename T, typename = void>
+struct HasCellNodes : std::false_type {};
+
+template <typename Stepper, typename T>
+struct HasCellNodes<Stepper, T, std::void_t<decltype(
+    std::declval<const Stepper&>().cellNodes(std::declval<T>(), std::declval<T>(), NodeSink<T> {})
+)>> : std::true_type {};
+
+template <typename Stepper, typename T, typename = void>
+struct HasSharedEndpoints : std::false_type {};
+
+template <typename Stepper, typename T>
+struct HasSharedEndpoints<Stepper, T, std::void_t<decltype(
+    std::declval<const Stepper&>().endpointWeight(std::declval<T>())
+)>> : std::true_type {};
+
+template <typename T, size_t intervals>
+constexpr std::array<T, intervals + 1> newtonCotesWeights() {
+    if constexpr (intervals == 1) {
+        return {{ T(1) / 2, T(1) / 2 }};
+    } else if constexpr (intervals == 2) {
+        return {{ T(1) / 6, T(4) / 6, T(1) / 6 }};
+    } else {
+        return {{ T(7) / 90, T(32) / 90, T(12) / 90, T(32) / 90, T(7) / 90 }};
+    }
+}
+
+} // detail
+
+/**
+ * Whether Stepper<T> places its nodes independently of function values (i.e. has cellNodes()), so that
+ * it can be tabulated into QuadratureRule.
+ */
+template <template <typename> typename Stepper, typename T>
+constexpr bool hasFixedNodes = detail::HasCellNodes<Stepper<T>, T>::value;
+
+/**
+ * Quadrature rule as a list of nodes and weights: integral of f is approximated by sum(weights[i] * f(nodes[i])).
+ *
+ * Nodes and weights are stored in contiguous arrays, so that applying the same rule to many functions (as
+ * galerkin does) does not regenerate them and streams through memory. Can be passed to integral objects
+ * (and innerProduct) in place of Range.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+class QuadratureRule {
+    std::vector<T> nodes_;
+    std::vector<T> weights_;
+
+public:
+    QuadratureRule() = default;
+
+    QuadratureRule(std::vector<T> nodes, std::vector<T> weights)
+        : nodes_(std::move(nodes)), weights_(std::move(weights)) {
+    }
+
+    /**
+     * Tabulates stepper over range. Nodes shared by adjacent cells (e.g. cell endpoints) are merged.
+     * @tparam Stepper - stepper with fixed nodes (see hasFixedNodes), e.g. Euler or GK21.
+     */
+    template <template <typename> typename Stepper>
+    static QuadratureRule fromRange(Range<T> range) {
+        static_assert(hasFixedNodes<Stepper, T>, "Stepper nodes depend on function values and can't be tabulated");
+        QuadratureRule rule;
+        Stepper<T> stepper;
+        const auto emit = [&rule, &range](T node, T weight) {
+            // x + h of a cell and x of the next one may differ in the last bits
+            const T tolerance = 4 * std::numeric_limits<T>::epsilon() * (std::abs(node) + std::abs(range.step()));
+            if (!rule.nodes_.empty() && std::abs(rule.nodes_.back() - node) <= tolerance) {
+                rule.weights_.back() += weight;
+            } else {
+                rule.nodes_.push_back(node);
+                rule.weights_.push_back(weight);
+            }
+        };
+        for (auto x : range) {
+            stepper.cellNodes(range.step(), x, emit);
+        }
+        rule.nodes_.shrink_to_fit();
+        rule.weights_.shrink_to_fit();
+        return rule;
+    }
+
+    /**
+     * Builds n-point Gauss-Legendre rule on [from, to], exact for polynomials of degree up to 2n - 1.
+     */
+    static QuadratureRule gaussLegendre(size_t n, T from, T to) {
+        std::vector<T> nodes (n), weights (n);
+        const T center = (from + to) / 2;
+        const T halfLength = (to - from) / 2;
+        const long double pi = 3.141592653589793238462643383279502884L;
+        for (size_t i = 0; i < (n + 1) / 2; ++i) {
+            // Newton iterations for i-th root of P_n, starting from asymptotic approximation
+            long double z = std::cos(pi * (i + 0.75L) / (n + 0.5L));
+            long double derivative = 1;
+            for (int iteration = 0; iteration < 100; ++iteration) {
+                long double p = 1, pPrev = 0;
+                for (size_t k = 1; k <= n; ++k) {
+                    const long double pPrevPrev = pPrev;
+                    pPrev = p;
+                    p = ((2*k - 1) * z * pPrev - (k - 1) * pPrevPrev) / k;
+                }
+                derivative = n * (z * p - pPrev) / (z * z - 1);
+                const long double delta = p / derivative;
+                z -= delta;
+                if (std::abs(delta) <= std::numeric_limits<long double>::epsilon()) {
+                    break;
+                }
+            }
+            const long double weight = 2 / ((1 - z * z) * derivative * derivative);
+            nodes[i] = static_cast<T>(center - halfLength * z);
+            nodes[n - 1 - i] = static_cast<T>(center + halfLength * z);
+            weights[i] = weights[n - 1 - i] = static_cast<T>(halfLength * weight);
+        }
+        return QuadratureRule { std::move(nodes), std::move(weights) };
+    }
+
+    /**
+     * Builds n-point Clenshaw-Curtis rule on [from, to]: nodes are extrema of Chebyshev polynomial T_{n-1}
+     * (a single midpoint if n = 1). Rules with n = 2^k + 1 points are nested, which sparse grids rely on.
+     */
+    static QuadratureRule clenshawCurtis(size_t n, T from, T to) {
+        const T center = (from + to) / 2;
+        const T halfLength = (to - from) / 2;
+        if (n == 1) {
+            return QuadratureRule { { center }, { 2 * halfLength } };
+        }
+        std::vector<T> nodes (n), weights (n);
+        const long double pi = 3.141592653589793238462643383279502884L;
+        const size_t N = n - 1;
+        for (size_t j = 0; j <= N / 2; ++j) {
+            const long double theta = pi * j / N;
+            long double sum = 0;
+            for (size_t k = 1; 2 * k <= N; ++k) {
+                sum += (2 * k == N ? 1 : 2) * std::cos(2 * k * theta) / (4.0L * k * k - 1);
+            }
+            const long double weight = (j == 0 ? 1 : 2) * (1 - sum) / N;
+            const long double z = 2 * j == N ? 0 : std::cos(theta);
+            nodes[j] = static_cast<T>(center - halfLength * z);
+            nodes[N - j] = static_cast<T>(center + halfLength * z);
+            weights[j] = weights[N - j] = static_cast<T>(halfLength * weight);
+        }
+        return QuadratureRule { std::move(nodes), std::move(weights) };
+    }
+
+    inline size_t size() const noexcept {
+        return nodes_.size();
+    }
+
+    inline const std::vector<T>& nodes() const noexcept {
+        return nodes_;
+    }
+
+    inline const std::vector<T>& weights() const noexcept {
+        return weights_;
+    }
+
+    /**
+     * Applies rule to nodes [first, last) of f (single-argument function object).
+     *
+     * If f supports batches (see batched()), nodes and weights are loaded batchSizeOf<F> at a time, and the sum
+     * is accumulated in batch lanes; the remaining nodes are processed one by one.
+     */
+    template <template <typename> typename Accumulator = NaiveSum, typename F>
+    T integrate(const F& f, size_t first, size_t last) const {
+        Accumulator<T> acc;
+        if constexpr (constexpr size_t N = batchSizeOf<F>; N > 0) {
+            Accumulator<Batch<T, N>> batchAcc;
+            for (; first + N <= last; first += N) {
+                Batch<T, N> x, w;
+                for (size_t lane = 0; lane < N; ++lane) {
+                    x[lane] = nodes_[first + lane];
+                    w[lane] = weights_[first + lane];
+                }
+                batchAcc.add(w * asBatch<T, N>(f(x)));
+            }
+            const auto lanes = batchAcc.result();
+            for (size_t lane = 0; lane < N; ++lane) {
+                acc.add(lanes[lane]);
+            }
+        }
+        for (; first < last; ++first) {
+            acc.add(weights_[first] * f(nodes_[first]));
+        }
+        return acc.result();
+    }
+
+    /**
+     * Applies rule to f (single-argument function object).
+     */
+    template <template <typename> typename Accumulator = NaiveSum, typename F>
+    T integrate(const F& f) const {
+        return integrate<Accumulator>(f, 0, size());
+    }
+};
+
+/**
+ * Closed Newton-Cotes integral stepper: integrates f over the cell [x, x + h] using values at intervals + 1
+ * equally spaced nodes, including both endpoints.
+ *
+ * Right endpoint of a cell is the left endpoint of the next one. To evaluate f there only once, integral sums
+ * sharedCell() over the range, which moves weight of the right endpoint to the left one, and then corrects the
+ * boundaries with endpointWeight(). Thus Trapezoid, Simpson and Boole cost 1, 2 and 4 evaluations per cell.
+ * @tparam T - floating point type to use (usually deduced)
+ * @tparam intervals - number of subintervals of a cell: 1, 2 or 4.
+ */
+template <typename T, size_t intervals>
+struct NewtonCotes {
+    static_assert(intervals == 1 || intervals == 2 || intervals == 4, "Only 1, 2 and 4 intervals are supported");
+
+    static constexpr size_t points = intervals + 1;
+
+    /**
+     * Weights of nodes x + i*h/intervals, relative to h.
+     */
+    static constexpr std::array<T, points> weights = detail::newtonCotesWeights<T, intervals>();
+
+    /**
+     * Integral stepper interface: integrates f over the cell [x, x + h].
+     */
+    template <typename F, typename X>
+    auto operator()(const F& f, T h, X x) const {
+        return cell(f, h, x, std::make_index_sequence<points> {});
+    }
+
+    /**
+     * Shared endpoints interface: integrates f over the cell [x, x + h] without evaluating f(x + h); its weight
+     * is added to the weight of x instead.
+     */
+    template <typename F, typename X>
+    auto sharedCell(const F& f, T h, X x) const {
+        return sharedCell(f, h, x, std::make_index_sequence<intervals - 1> {});
+    }
+
+    /**
+     * Shared endpoints interface: sum of sharedCell over cells of [a, b] plus endpointWeight(h) * (f(b) - f(a))
+     * is the composite rule.
+     */
+    inline T endpointWeight(T h) const noexcept {
+        return h * weights[intervals];
+    }
+
+    /**
+     * Fixed nodes interface: calls emit(node, weight) for every node of the rule on the cell [x, x + h].
+     */
+    template <typename Emit>
+    void cellNodes(T h, T x, Emit&& emit) const {
+        for (size_t i = 0; i < points; ++i) {
+            emit(i == 0 ? x : x + h * i / intervals, h * weights[i]);
+        }
+    }
+
+private:
+    template <size_t i, typename X>
+    static inline X node(T h, X x) noexcept {
+        if constexpr (i == 0) {
+            return x;
+        } else {
+            return x + h * i / intervals;
+        }
+    }
+
+    template <typename F, typename X, size_t ... Is>
+    auto cell(const F& f, T h, X x, std::index_sequence<Is...>) const {
+        return h * ((weights[Is] * f(node<Is>(h, x))) + ...);
+    }
+
+    template <typename F, typename X, size_t ... Is>
+    auto sharedCell(const F& f, T h, X x, std::index_sequence<Is...>) const {
+        return h * (((weights[0] + weights[intervals]) * f(x)) + ... + (weights[Is + 1] * f(node<Is + 1>(h, x))));
+    }
+};
+
+/**
+ * Trapezoidal rule, 2nd order.
+ */
+template <typename T>
+using Trapezoid = NewtonCotes<T, 1>;
+
+/**
+ * Simpson's rule, 4th order.
+ */
+template <typename T>
+using Simpson = NewtonCotes<T, 2>;
+
+/**
+ * Boole's rule, 6th order.
+ */
+template <typename T>
+using Boole = NewtonCotes<T, 4>;
+
+/**
+ * n-point Gauss-Legendre integral stepper: integrates f over the cell [x, x + h] exactly for polynomials of degree
+ * up to 2n - 1. Nodes are interior, so nothing is shared between cells.
+ *
+ * Nodes and weights are computed once, when stepper is constructed (integral keeps its stepper).
+ * @tparam T - floating point type to use (usually deduced)
+ * @tparam n - number of nodes per cell.
+ */
+template <typename T, size_t n>
+struct GaussLegendre {
+    static_assert(n > 0, "Gauss-Legendre rule needs at least one node");
+
+    static constexpr size_t points = n;
+
+    /**
+     * Nodes and weights on [0, 1], i.e. relative to the cell.
+     */
+    std::array<T, n> nodes, weights;
+
+    GaussLegendre() {
+        const auto rule = QuadratureRule<T>::gaussLegendre(n, 0, 1);
+        std::copy(rule.nodes().begin(), rule.nodes().end(), nodes.begin());
+        std::copy(rule.weights().begin(), rule.weights().end(), weights.begin());
+    }
+
+    /**
+     * Integral stepper interface: integrates f over the cell [x, x + h].
+     */
+    template <typename F, typename X>
+    auto operator()(const F& f, T h, X x) const {
+        return cell(f, h, x, std::make_index_sequence<n> {});
+    }
+
+    /**
+     * Fixed nodes interface: calls emit(node, weight) for every node of the rule on the cell [x, x + h].
+     */
+    template <typename Emit>
+    void cellNodes(T h, T x, Emit&& emit) const {
+        for (size_t i = 0; i < n; ++i) {
+            emit(x + h * nodes[i], h * weights[i]);
+        }
+    }
+
+private:
+    template <typename F, typename X, size_t ... Is>
+    auto cell(const F& f, T h, X x, std::index_sequence<Is...>) const {
+        return h * ((weights[Is] * f(x + h * nodes[Is])) + ...);
+    }
+};
+
+template <typename T>
+using GL2 = GaussLegendre<T, 2>;
+
+template <typename T>
+using GL3 = GaussLegendre<T, 3>;
+
+template <typename T>
+using GL4 = GaussLegendre<T, 4>;
+
+template <typename T>
+using GL5 = GaussLegendre<T, 5>;
+
+/**
+ * Thread-safe cache of quadrature rules, keyed by (rule kind, interval, size).
+ *
+ * Caching is opt-in: library functions never fill the cache themselves, rules are added only by explicit calls
+ * and are kept until clear(). Rules are immutable once built and shared via shared_ptr, so they remain valid even
+ * if cache is cleared.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+class QuadratureRuleCache {
+    struct GaussLegendreKind {};
+
+    using Key = std::tuple<std::type_index, T, T, size_t>;
+
+    std::map<Key, std::shared_ptr<const QuadratureRule<T>>> rules_;
+    std::mutex mutex_;
+
+    template <typename Build>
+    std::shared_ptr<const QuadratureRule<T>> getOrBuild(const Key& key, Build build) {
+        std::lock_guard lock { mutex_ };
+        auto it = rules_.find(key);
+        if (it == rules_.end()) {
+            it = rules_.emplace(key, std::make_shared<const QuadratureRule<T>>(build())).first;
+        }
+        return it->second;
+    }
+
+public:
+    /**
+     * @return Rule built by QuadratureRule::fromRange<Stepper>(range).
+     */
+    template <template <typename> typename Stepper>
+    std::shared_ptr<const QuadratureRule<T>> fromRange(Range<T> range) {
+        return getOrBuild(Key { typeid(Stepper<T>), range.start(), range.step(), range.count() }, [range] {
+            return QuadratureRule<T>::template fromRange<Stepper>(range);
+        });
+    }
+
+    /**
+     * @return Rule built by QuadratureRule::gaussLegendre(n, from, to).
+     */
+    std::shared_ptr<const QuadratureRule<T>> gaussLegendre(size_t n, T from, T to) {
+        return getOrBuild(Key { typeid(GaussLegendreKind), from, to, n }, [=] {
+            return QuadratureRule<T>::gaussLegendre(n, from, to);
+        });
+    }
+
+    inline size_t size() {
+        std::lock_guard lock { mutex_ };
+        return rules_.size();
+    }
+
+    inline void clear() {
+        std::lock_guard lock { mutex_ };
+        rules_.clear();
+    }
+
+    /**
+     * @brief Returns process-wide cache.
+     */
+    static QuadratureRuleCache& instance() {
+        static QuadratureRuleCache cache;
+        return cache;
+    }
+};
+
+} // nya
+
+#endif //NUMUTILS_QUADRATURE_HPP
@@ -0,0 +1,241 @@
+#ifndef NUMUTILS_RANDOM_HPP
+#define NUMUTILS_RANDOM_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace nya {
+
+/**
+ * Philox4x32-10 counter-based random number generator (Salmon et al., "Parallel random numbers: as easy as
+ * 1, 2, 3").
+ *
+ * Output is a pure function of (counter, key), so any element of any stream can be computed directly: streams
+ * are selected by key (or part of the counter), and threads need neither shared state nor skip-ahead.
+ */
+struct Philox4x32 {
+    using Counter = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    static constexpr size_t rounds = 10;
+
+    static Counter generate(Counter counter, Key key) noexcept {
+        for (size_t round = 0; round < rounds; ++round) {
+            if (round > 0) {
+                key[0] += 0x9E3779B9;
+                key[1] += 0xBB67AE85;
+            }
+            const uint64_t product0 = uint64_t(0xD2511F53) * counter[0];
+            const uint64_t product1 = uint64_t(0xCD9E8D57) * counter[2];
+            counter = {
+                uint32_t(product1 >> 32) ^ counter[1] ^ key[0], uint32_t(product1),
+                uint32_t(product0 >> 32) ^ counter[3] ^ key[1], uint32_t(product0),
+            };
+        }
+        return counter;
+    }
+
+    /**
+     * @brief Returns uniformly distributed value in [0, 1) made of two 32-bit words (53 random bits for double).
+     */
+    template <typename T>
+    static inline T uniform(uint32_t high, uint32_t low) noexcept {
+        const uint64_t bits = (uint64_t(high) << 32) | low;
+        return static_cast<T>(bits >> 11) * static_cast<T>(0x1.0p-53);
+    }
+};
+
+/**
+ * Point sets for Monte Carlo integration in the unit cube.
+ *
+ * Every sequence is constructed from (dimension, seed, replicate) and provides point(index, out), which writes
+ * coordinates of point with given index to out[0 .. dimension). Points are computed directly from index, so
+ * disjoint index ranges can be generated concurrently, with results not depending on how they are split.
+ * Different replicates are statistically independent: they are different random streams for PseudoRandom, and
+ * independent random shifts of the same low-discrepancy point set for Sobol and Halton (randomized QMC).
+ * quasiRandom tells whether the points are low-discrepancy (so that error should be estimated from
+ * replicates rather than from sample variance), maxPoints is the number of distinct points (index should be
+ * less than it).
+ */
+
+/**
+ * Independent uniformly distributed points, generated with Philox4x32 (counter = index and replicate,
+ * key = seed).
+ * @tparam T - floating point type.
+ */
+template <typename T>
+class PseudoRandom {
+    size_t dimension_;
+    Philox4x32::Key key_;
+    uint32_t replicate_;
+
+public:
+    static constexpr bool quasiRandom = false;
+    static constexpr uint64_t maxPoints = std::numeric_limits<uint64_t>::max();
+
+    PseudoRandom(size_t dimension, uint64_t seed, size_t replicate)
+        : dimension_(dimension), key_ { uint32_t(seed), uint32_t(seed >> 32) }, replicate_(uint32_t(replicate)) {
+    }
+
+    inline size_t dimension() const noexcept {
+        return dimension_;
+    }
+
+    void point(uint64_t index, T* out) const noexcept {
+        for (size_t d = 0; d < dimension_; d += 2) {
+            const auto r = Philox4x32::generate({ uint32_t(index), uint32_t(index >> 32), uint32_t(d / 2), replicate_ },
+                                                key_);
+            out[d] = Philox4x32::uniform<T>(r[0], r[1]);
+            if (d + 1 < dimension_) {
+                out[d + 1] = Philox4x32::uniform<T>(r[2], r[3]);
+            }
+        }
+    }
+};
+
+/**
+ * Sobol low-discrepancy sequence (direction numbers of Joe and Kuo) with random digital shift, up to 16 dimensions.
+ *
+ * Index is limited to maxPoints = 2^32 (higher bits are ignored). Integration error of smooth functions decreases nearly as O(1/n) instead of
+ * O(1/sqrt(n)), especially for n being powers of two.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+class Sobol {
+    struct Polynomial {
+        uint32_t degree;
+        uint32_t coefficients;
+        uint32_t m[6];
+    };
+
+    static constexpr size_t bits = 32;
+
+    size_t dimension_;
+    std::vector<std::array<uint32_t, bits>> directions_;
+    std::vector<uint32_t> shifts_;
+
+public:
+    static constexpr bool quasiRandom = true;
+    static constexpr uint64_t maxPoints = uint64_t(1) << bits;
+    static constexpr size_t maxDimension = 16;
+
+    Sobol(size_t dimension, uint64_t seed, size_t replicate)
+        : dimension_(dimension), directions_(dimension), shifts_(dimension) {
+        if (dimension > maxDimension) {
+            throw std::invalid_argument("Sobol sequence supports up to 16 dimensions");
+        }
+        // primitive polynomials and initial direction numbers for dimensions 2 .. 16 (new-joe-kuo-6.21201)
+        static constexpr Polynomial polynomials[maxDimension - 1] = {
+            { 1, 0, { 1 } }, { 2, 1, { 1, 3 } }, { 3, 1, { 1, 3, 1 } }, { 3, 2, { 1, 1, 1 } },
+            { 4, 1, { 1, 1, 3, 3 } }, { 4, 4, { 1, 3, 5, 13 } }, { 5, 2, { 1, 1, 5, 5, 17 } },
+            { 5, 4, { 1, 1, 5, 5, 5 } }, { 5, 7, { 1, 1, 7, 11, 19 } }, { 5, 11, { 1, 1, 5, 1, 1 } },
+            { 5, 13, { 1, 1, 1, 3, 11 } }, { 5, 14, { 1, 3, 5, 5, 31 } }, { 6, 1, { 1, 3, 3, 9, 7, 49 } },
+            { 6, 13, { 1, 1, 1, 15, 21, 21 } }, { 6, 16, { 1, 3, 1, 13, 27, 49 } },
+        };
+        for (size_t d = 0; d < dimension; ++d) {
+            auto& v = directions_[d];
+            if (d == 0) {
+                for (size_t i = 0; i < bits; ++i) {
+                    v[i] = uint32_t(1) << (bits - 1 - i);
+                }
+            } else {
+                const Polynomial& p = polynomials[d - 1];
+                const size_t s = p.degree;
+                for (size_t i = 0; i < s; ++i) {
+                    v[i] = p.m[i] << (bits - 1 - i);
+                }
+                for (size_t i = s; i < bits; ++i) {
+                    v[i] = v[i - s] ^ (v[i - s] >> s);
+                    for (size_t k = 1; k < s; ++k) {
+                        v[i] ^= ((p.coefficients >> (s - 1 - k)) & 1) * v[i - k];
+                    }
+                }
+            }
+            shifts_[d] = Philox4x32::generate({ uint32_t(d), uint32_t(replicate), 0x50B0, 0 },
+                                              { uint32_t(seed), uint32_t(seed >> 32) })[0];
+        }
+    }
+
+    inline size_t dimension() const noexcept {
+        return dimension_;
+    }
+
+    void point(uint64_t index, T* out) const noexcept {
+        const uint32_t gray = uint32_t(index ^ (index >> 1));
+        for (size_t d = 0; d < dimension_; ++d) {
+            uint32_t x = shifts_[d];
+            for (uint32_t g = gray, i = 0; g != 0; g >>= 1, ++i) {
+                if (g & 1) {
+                    x ^= directions_[d][i];
+                }
+            }
+            out[d] = (static_cast<T>(x) + static_cast<T>(0.5)) * static_cast<T>(0x1.0p-32);
+        }
+    }
+};
+
+/**
+ * Halton low-discrepancy sequence (radical inverses in bases of consecutive primes) with random shift modulo 1.
+ *
+ * Works in any dimension, but quality degrades for large bases, so it is best suited for a few dimensions.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+class Halton {
+    size_t dimension_;
+    std::vector<uint32_t> bases_;
+    std::vector<T> shifts_;
+
+public:
+    static constexpr bool quasiRandom = true;
+    static constexpr uint64_t maxPoints = std::numeric_limits<uint64_t>::max();
+
+    Halton(size_t dimension, uint64_t seed, size_t replicate) : dimension_(dimension), shifts_(dimension) {
+        for (uint32_t candidate = 2; bases_.size() < dimension; ++candidate) {
+            bool prime = true;
+            for (auto base : bases_) {
+                if (base * base > candidate) {
+                    break;
+                }
+                if (candidate % base == 0) {
+                    prime = false;
+                    break;
+                }
+            }
+            if (prime) {
+                bases_.push_back(candidate);
+            }
+        }
+        for (size_t d = 0; d < dimension; ++d) {
+            const auto r = Philox4x32::generate({ uint32_t(d), uint32_t(replicate), 0x4A17, 0 },
+                                                { uint32_t(seed), uint32_t(seed >> 32) });
+            shifts_[d] = Philox4x32::uniform<T>(r[0], r[1]);
+        }
+    }
+
+    inline size_t dimension() const noexcept {
+        return dimension_;
+    }
+
+    void point(uint64_t index, T* out) const noexcept {
+        for (size_t d = 0; d < dimension_; ++d) {
+            const uint32_t base = bases_[d];
+            const T inverseBase = T(1) / base;
+            T x = 0, scale = inverseBase;
+            for (uint64_t i = index; i != 0; i /= base, scale *= inverseBase) {
+                x += (i % base) * scale;
+            }
+            x += shifts_[d];
+            out[d] = x >= 1 ? x - 1 : x;
+        }
+    }
+};
+
+} // nya
+
+#endif //NUMUTILS_RANDOM_HPP
@@ -0,0 +1,661 @@
+#ifndef NUMUTILS_SPARSE_HPP
+#define NUMUTILS_SPARSE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Surface.hpp"
+#include "ThreadPool.hpp"
+
+namespace nya {
+
+/**
+ * Element (row, column, value) of a sparse matrix, as produced by assembly loops.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+struct Triplet {
+    size_t row;
+    size_t column;
+    T value;
+};
+
+/**
+ * Sparse matrix in compressed sparse row (CSR) format.
+ *
+ * Nonzeros of row i are values()[rowOffsets()[i] .. rowOffsets()[i + 1]), with column indices in increasing
+ * order. The pattern is fixed after construction, but values may be overwritten, e.g. to reassemble a system
+ * with the same structure.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+class SparseMatrix {
+    size_t rows_ = 0;
+    size_t columns_ = 0;
+    std::vector<size_t> offsets_ = { 0 };
+    std::vector<size_t> indices_;
+    std::vector<T> values_;
+
+public:
+    SparseMatrix() = default;
+
+    /**
+     * Takes CSR arrays as they are.
+     * @throws std::invalid_argument if arrays are inconsistent or columns of a row are not strictly increasing.
+     */
+    SparseMatrix(size_t rows, size_t columns,
+                 std::vector<size_t> offsets, std::vector<size_t> indices, std::vector<T> values)
+        : rows_(rows), columns_(columns),
+          offsets_(std::move(offsets)), indices_(std::move(indices)), values_(std::move(values)) {
+        if (offsets_.size() != rows + 1 || offsets_.front() != 0 || offsets_.back() != indices_.size()
+            || indices_.size() != values_.size()) {
+            throw std::invalid_argument("SparseMatrix: sizes of CSR arrays do not match");
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            if (offsets_[i] > offsets_[i + 1]) {
+                throw std::invalid_argument("SparseMatrix: row offsets are decreasing");
+            }
+            for (size_t p = offsets_[i]; p < offsets_[i + 1]; ++p) {
+                if (indices_[p] >= columns || (p > offsets_[i] && indices_[p] <= indices_[p - 1])) {
+                    throw std::invalid_argument("SparseMatrix: column indices are out of range or not increasing");
+                }
+            }
+        }
+    }
+
+    /**
+     * Copies elements of A (Surface of any storage order) whose absolute value exceeds tolerance.
+     */
+    template <bool rowMajor, typename Alloc>
+    explicit SparseMatrix(const Surface<T, rowMajor, Alloc>& A, T tolerance = 0)
+        : rows_(A.sizeX()), columns_(A.sizeY()) {
+        offsets_.reserve(rows_ + 1);
+        for (size_t i = 0; i < rows_; ++i) {
+            for (size_t j = 0; j < columns_; ++j) {
+                if (std::abs(A.at(i, j)) > tolerance) {
+                    indices_.push_back(j);
+                    values_.push_back(A.at(i, j));
+                }
+            }
+            offsets_.push_back(indices_.size());
+        }
+    }
+
+    /**
+     * Assembles matrix from triplets in any order; values of repeated (row, column) pairs are summed, as
+     * contributions of elements in finite element assembly.
+     * @throws std::invalid_argument if a triplet is out of range.
+     */
+    static SparseMatrix fromTriplets(size_t rows, size_t columns, const std::vector<Triplet<T>>& triplets) {
+        // counting sort by row, then sort and merge every row
+        std::vector<size_t> offsets (rows + 1, 0);
+        for (const auto& t : triplets) {
+            if (t.row >= rows || t.column >= columns) {
+                throw std::invalid_argument("SparseMatrix: triplet is out of range");
+            }
+            ++offsets[t.row + 1];
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            offsets[i + 1] += offsets[i];
+        }
+        std::vector<std::pair<size_t, T>> entries (triplets.size());
+        std::vector<size_t> next (offsets.begin(), offsets.end() - 1);
+        for (const auto& t : triplets) {
+            entries[next[t.row]++] = { t.column, t.value };
+        }
+
+        std::vector<size_t> mergedOffsets (rows + 1, 0);
+        std::vector<size_t> indices;
+        std::vector<T> values;
+        indices.reserve(entries.size());
+        values.reserve(entries.size());
+        for (size_t i = 0; i < rows; ++i) {
+            const auto first = entries.begin() + offsets[i], last = entries.begin() + offsets[i + 1];
+            std::sort(first, last, [](const auto& a, const auto& b) { return a.first < b.first; });
+            for (auto it = first; it != last; ++it) {
+                if (indices.size() > mergedOffsets[i] && indices.back() == it->first) {
+                    values.back() += it->second;
+                } else {
+                    indices.push_back(it->first);
+                    values.push_back(it->second);
+                }
+            }
+            mergedOffsets[i + 1] = indices.size();
+        }
+        return SparseMatrix(rows, columns, std::move(mergedOffsets), std::move(indices), std::move(values));
+    }
+
+    inline size_t rows() const noexcept {
+        return rows_;
+    }
+
+    inline size_t columns() const noexcept {
+        return columns_;
+    }
+
+    /**
+     * @brief Returns number of stored elements.
+     */
+    inline size_t nonZeros() const noexcept {
+        return values_.size();
+    }
+
+    inline const std::vector<size_t>& rowOffsets() const noexcept {
+        return offsets_;
+    }
+
+    inline const std::vector<size_t>& columnIndices() const noexcept {
+        return indices_;
+    }
+
+    inline const std::vector<T>& values() const noexcept {
+        return values_;
+    }
+
+    inline std::vector<T>& values() noexcept {
+        return values_;
+    }
+
+    /**
+     * @brief Returns position of element (i, j) in values(), or nonZeros() if it is not stored.
+     */
+    size_t find(size_t i, size_t j) const noexcept {
+        const auto first = indices_.begin() + offsets_[i], last = indices_.begin() + offsets_[i + 1];
+        const auto it = std::lower_bound(first, last, j);
+        return it != last && *it == j ? static_cast<size_t>(it - indices_.begin()) : values_.size();
+    }
+
+    /**
+     * @brief Returns element (i, j), which is zero if it is not stored (binary search within row i).
+     */
+    T at(size_t i, size_t j) const noexcept {
+        const size_t p = find(i, j);
+        return p < values_.size() ? values_[p] : T(0);
+    }
+
+    std::vector<T> diagonal() const {
+        std::vector<T> result (std::min(rows_, columns_));
+        for (size_t i = 0; i < result.size(); ++i) {
+            result[i] = at(i, i);
+        }
+        return result;
+    }
+};
+
+namespace detail {
+
+/**
+ * Rows of sparse matrix multiplied by a single task, and elements of vectors updated or reduced by a single task
+ * of iterative solvers.
+ */
+constexpr size_t spmvRowTile = 1 << 10;
+constexpr size_t vectorChunkSize = 1 << 13;
+
+/**
+ * Calls body(first, last) for consecutive chunks of [0, count), in parallel if policy is parallel.
+ */
+template <typename Policy, typename F>
+void forEachChunk(Policy policy, size_t count, size_t chunkSize, F&& body) {
+    forEachIndex(policy, (count + chunkSize - 1) / chunkSize, [&](size_t chunk) {
+        const size_t first = chunk * chunkSize;
+        body(first, std::min(first + chunkSize, count));
+    });
+}
+
+/**
+ * y = A x.
+ */
+template <typename Policy, typename T>
+void spmv(Policy policy, const SparseMatrix<T>& A, const T* x, T* y) {
+    const size_t* offsets = A.rowOffsets().data();
+    const size_t* indices = A.columnIndices().data();
+    const T* values = A.values().data();
+    forEachChunk(policy, A.rows(), spmvRowTile, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            T sum = 0;
+            for (size_t p = offsets[i]; p < offsets[i + 1]; ++p) {
+                sum += values[p] * x[indices[p]];
+            }
+            y[i] = sum;
+        }
+    });
+}
+
+/**
+ * Dot product; partial sums of chunks are added in chunk order, so the result does not depend on the number
+ * of threads.
+ */
+template <typename Policy, typename T>
+T dot(Policy policy, const std::vector<T>& x, const std::vector<T>& y) {
+    const size_t chunks = (x.size() + vectorChunkSize - 1) / vectorChunkSize;
+    std::vector<T> partials (chunks);
+    forEachChunk(policy, x.size(), vectorChunkSize, [&](size_t first, size_t last) {
+        T sum = 0;
+        for (size_t i = first; i < last; ++i) {
+            sum += x[i] * y[i];
+        }
+        partials[first / vectorChunkSize] = sum;
+    });
+    T result = 0;
+    for (const T partial : partials) {
+        result += partial;
+    }
+    return result;
+}
+
+template <typename Policy, typename T>
+T norm(Policy policy, const std::vector<T>& x) {
+    return std::sqrt(dot(policy, x, x));
+}
+
+/**
+ * r = b - A x.
+ */
+template <typename Policy, typename T>
+void residual(Policy policy, const SparseMatrix<T>& A, const std::vector<T>& x, const std::vector<T>& b,
+              std::vector<T>& r) {
+    spmv(policy, A, x.data(), r.data());
+    forEachChunk(policy, r.size(), vectorChunkSize, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            r[i] = b[i] - r[i];
+        }
+    });
+}
+
+template <typename T>
+void checkSystem(const SparseMatrix<T>& A, const std::vector<T>& b, const char* solver) {
+    if (A.rows() != A.columns() || A.rows() != b.size()) {
+        throw std::invalid_argument(std::string(solver) + ": matrix and vector sizes do not match");
+    }
+}
+
+} // detail
+
+/**
+ * Preconditioners approximate A^-1: apply(r, z) computes z = M^-1 r (z has the size of r).
+ */
+
+/**
+ * No preconditioning: z = r.
+ */
+struct IdentityPreconditioner {
+    template <typename T>
+    void apply(const std::vector<T>& r, std::vector<T>& z) const {
+        std::copy(r.begin(), r.end(), z.begin());
+    }
+};
+
+/**
+ * Jacobi (diagonal) preconditioner: z = r / diag(A). Cheap, and keeps CG applicable to symmetric positive
+ * definite A.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+class JacobiPreconditioner {
+    std::vector<T> inverseDiagonal_;
+
+public:
+    /**
+     * @throws std::invalid_argument if a diagonal element of A is zero.
+     */
+    explicit JacobiPreconditioner(const SparseMatrix<T>& A) : inverseDiagonal_(A.diagonal()) {
+        for (auto& d : inverseDiagonal_) {
+            if (d == T(0)) {
+                throw std::invalid_argument("JacobiPreconditioner: zero on the diagonal");
+            }
+            d = T(1) / d;
+        }
+    }
+
+    void apply(const std::vector<T>& r, std::vector<T>& z) const {
+        for (size_t i = 0; i < r.size(); ++i) {
+            z[i] = r[i] * inverseDiagonal_[i];
+        }
+    }
+};
+
+/**
+ * Incomplete LU factorization without fill-in, ILU(0): A ~ L U, where L (unit lower) and U have the sparsity
+ * pattern of A. Usually cuts GMRES iterations several times for matrices of discretized PDEs, at the cost of
+ * two sequential triangular solves per iteration.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+class ILU0Preconditioner {
+    SparseMatrix<T> LU_;
+    std::vector<size_t> diagonal_;
+
+public:
+    /**
+     * @throws std::invalid_argument if A is not square or a diagonal element is not stored.
+     * @throws std::runtime_error if a zero pivot occurs.
+     */
+    explicit ILU0Preconditioner(SparseMatrix<T> A) : LU_(std::move(A)), diagonal_(LU_.rows()) {
+        const size_t n = LU_.rows();
+        if (LU_.columns() != n) {
+            throw std::invalid_argument("ILU0Preconditioner: matrix is not square");
+        }
+        for (size_t i = 0; i < n; ++i) {
+            diagonal_[i] = LU_.find(i, i);
+            if (diagonal_[i] == LU_.nonZeros()) {
+                throw std::invalid_argument("ILU0Preconditioner: diagonal element is not stored");
+            }
+        }
+        const auto& offsets = LU_.rowOffsets();
+        const auto& indices = LU_.columnIndices();
+        auto& values = LU_.values();
+        // position of column j in the current row, or npos
+        constexpr size_t npos = std::numeric_limits<size_t>::max();
+        std::vector<size_t> position (n, npos);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t p = offsets[i]; p < offsets[i + 1]; ++p) {
+                position[indices[p]] = p;
+            }
+            for (size_t p = offsets[i]; p < diagonal_[i]; ++p) {
+                const size_t k = indices[p];
+                values[p] /= values[diagonal_[k]];
+                for (size_t q = diagonal_[k] + 1; q < offsets[k + 1]; ++q) {
+                    if (position[indices[q]] != npos) {
+                        values[position[indices[q]]] -= values[p] * values[q];
+                    }
+                }
+            }
+            if (values[diagonal_[i]] == T(0)) {
+                throw std::runtime_error("ILU0Preconditioner: zero pivot");
+            }
+            for (size_t p = offsets[i]; p < offsets[i + 1]; ++p) {
+                position[indices[p]] = npos;
+            }
+        }
+    }
+
+    void apply(const std::vector<T>& r, std::vector<T>& z) const {
+        const auto& offsets = LU_.rowOffsets();
+        const auto& indices = LU_.columnIndices();
+        const auto& values = LU_.values();
+        const size_t n = r.size();
+        for (size_t i = 0; i < n; ++i) {
+            T sum = r[i];
+            for (size_t p = offsets[i]; p < diagonal_[i]; ++p) {
+                sum -= values[p] * z[indices[p]];
+            }
+            z[i] = sum;
+        }
+        for (size_t i = n; i-- > 0;) {
+            T sum = z[i];
+            for (size_t p = diagonal_[i] + 1; p < offsets[i + 1]; ++p) {
+                sum -= values[p] * z[indices[p]];
+            }
+            z[i] = sum / values[diagonal_[i]];
+        }
+    }
+};
+
+/**
+ * Parameters of iterative solvers.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+struct IterativeOptions {
+    /**
+     * Iterations stop when norm of residual b - A x is below max(absTol, relTol * |b|), or after maxIterations.
+     */
+    T absTol = 0;
+    T relTol = T(1e-10);
+    size_t maxIterations = 1000;
+    /**
+     * Number of GMRES iterations between restarts (size of Krylov basis kept in memory).
+     */
+    size_t restart = 50;
+    /**
+     * If set, called after every iteration with its number (from 1) and residual norm; returning false stops
+     * the solver, e.g. to log convergence or to implement custom stopping criteria.
+     */
+    std::function<bool(size_t, T)> monitor;
+};
+
+/**
+ * Result of an iterative solver.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+struct IterativeResult {
+    std::vector<T> solution;
+    /**
+     * Norm of residual b - A x (for GMRES, as estimated by the solver between restarts).
+     */
+    T residual;
+    size_t iterations;
+    /**
+     * True if tolerance was met.
+     */
+    bool converged;
+};
+
+/**
+ * Solves A x = b with preconditioned conjugate gradient method, starting from x = 0.
+ *
+ * A must be symmetric positive definite (and so must be the preconditioner). Matrix-vector products, vector
+ * updates and dot products are split into chunks, which run in parallel with parallel policy; results do not
+ * depend on the number of threads.
+ * @tparam Preconditioner - type of preconditioner (see IdentityPreconditioner).
+ * @param policy - execution policy, e.g. execution::par.
+ * @param A - square sparse matrix.
+ * @param b - right-hand side.
+ * @param preconditioner - approximation of A^-1, e.g. JacobiPreconditioner.
+ * @param options - tolerances, iteration limit and convergence monitor.
+ * @throws std::invalid_argument if sizes of A and b do not match.
+ */
+template <
+    typename Policy, typename T, typename Preconditioner = IdentityPreconditioner,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+IterativeResult<T> conjugateGradient(Policy policy, const SparseMatrix<T>& A, const std::vector<T>& b,
+                                     const Preconditioner& preconditioner = {},
+                                     const IterativeOptions<T>& options = {}) {
+    detail::checkSystem(A, b, "conjugateGradient");
+    const size_t n = b.size();
+    const T target = std::max(options.absTol, options.relTol * detail::norm(policy, b));
+    IterativeResult<T> result { std::vector<T>(n), detail::norm(policy, b), 0, false };
+    std::vector<T>& x = result.solution;
+    std::vector<T> r = b, z (n), p (n), Ap (n);
+
+    preconditioner.apply(r, z);
+    p = z;
+    T rz = detail::dot(policy, r, z);
+    result.converged = result.residual <= target;
+    while (!result.converged && result.iterations < options.maxIterations) {
+        detail::spmv(policy, A, p.data(), Ap.data());
+        const T alpha = rz / detail::dot(policy, p, Ap);
+        detail::forEachChunk(policy, n, detail::vectorChunkSize, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                x[i] += alpha * p[i];
+                r[i] -= alpha * Ap[i];
+            }
+        });
+        result.residual = detail::norm(policy, r);
+        result.converged = result.residual <= target;
+        ++result.iterations;
+        const bool stopped = options.monitor && !options.monitor(result.iterations, result.residual);
+        if (result.converged || stopped) {
+            break;
+        }
+        preconditioner.apply(r, z);
+        const T rzNext = detail::dot(policy, r, z);
+        const T beta = rzNext / rz;
+        rz = rzNext;
+        detail::forEachChunk(policy, n, detail::vectorChunkSize, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                p[i] = z[i] + beta * p[i];
+            }
+        });
+    }
+    return result;
+}
+
+/**
+ * Solves A x = b with preconditioned conjugate gradient method sequentially.
+ */
+template <typename T, typename Preconditioner = IdentityPreconditioner>
+IterativeResult<T> conjugateGradient(const SparseMatrix<T>& A, const std::vector<T>& b,
+                                     const Preconditioner& preconditioner = {},
+                                     const IterativeOptions<T>& options = {}) {
+    return conjugateGradient(execution::seq, A, b, preconditioner, options);
+}
+
+/**
+ * Solves A x = b with restarted GMRES (generalized minimal residual method), starting from x = 0.
+ *
+ * Works for any nonsingular A. Preconditioning is applied from the right (A M^-1 u = b, x = M^-1 u), so that
+ * the minimized residual is the residual of the original system. Arnoldi vectors are orthogonalized with
+ * modified Gram-Schmidt, the least squares problem is updated with Givens rotations. After every restart
+ * the residual is recomputed as b - A x.
+ * @tparam Preconditioner - type of preconditioner (see IdentityPreconditioner).
+ * @param policy - execution policy, e.g. execution::par.
+ * @param A - square sparse matrix.
+ * @param b - right-hand side.
+ * @param preconditioner - approximation of A^-1, e.g. ILU0Preconditioner.
+ * @param options - tolerances, iteration limit, restart length and convergence monitor.
+ * @throws std::invalid_argument if sizes of A and b do not match.
+ */
+template <
+    typename Policy, typename T, typename Preconditioner = IdentityPreconditioner,
+    typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>
+>
+IterativeResult<T> gmres(Policy policy, const SparseMatrix<T>& A, const std::vector<T>& b,
+                         const Preconditioner& preconditioner = {}, const IterativeOptions<T>& options = {}) {
+    detail::checkSystem(A, b, "gmres");
+    const size_t n = b.size(), m = std::max<size_t>(options.restart, 1);
+    const T target = std::max(options.absTol, options.relTol * detail::norm(policy, b));
+    IterativeResult<T> result { std::vector<T>(n), detail::norm(policy, b), 0, false };
+    std::vector<T>& x = result.solution;
+
+    std::vector<std::vector<T>> V (m + 1, std::vector<T>(n));
+    Surface<T> H (m + 1, m, T(0));
+    std::vector<T> g (m + 1), cs (m), sn (m), y (m), z (n), w (n);
+    std::vector<T> r = b;
+    bool stopped = false;
+    result.converged = result.residual <= target;
+    while (!result.converged && !stopped && result.iterations < options.maxIterations) {
+        const T beta = result.residual;
+        detail::forEachChunk(policy, n, detail::vectorChunkSize, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                V[0][i] = r[i] / beta;
+            }
+        });
+        std::fill(g.begin(), g.end(), T(0));
+        g[0] = beta;
+        size_t k = 0;
+        while (k < m && result.iterations < options.maxIterations) {
+            preconditioner.apply(V[k], z);
+            detail::spmv(policy, A, z.data(), w.data());
+            for (size_t i = 0; i <= k; ++i) {
+                const T h = H.at(i, k) = detail::dot(policy, w, V[i]);
+                detail::forEachChunk(policy, n, detail::vectorChunkSize, [&](size_t first, size_t last) {
+                    for (size_t l = first; l < last; ++l) {
+                        w[l] -= h * V[i][l];
+                    }
+                });
+            }
+            const T hNext = detail::norm(policy, w);
+            if (hNext > T(0)) {
+                detail::forEachChunk(policy, n, detail::vectorChunkSize, [&](size_t first, size_t last) {
+                    for (size_t l = first; l < last; ++l) {
+                        V[k + 1][l] = w[l] / hNext;
+                    }
+                });
+            }
+            for (size_t i = 0; i < k; ++i) {
+                const T a = H.at(i, k), c = H.at(i + 1, k);
+                H.at(i, k) = cs[i] * a + sn[i] * c;
+                H.at(i + 1, k) = -sn[i] * a + cs[i] * c;
+            }
+            const T d = std::hypot(H.at(k, k), hNext);
+            cs[k] = H.at(k, k) / d;
+            sn[k] = hNext / d;
+            H.at(k, k) = d;
+            g[k + 1] = -sn[k] * g[k];
+            g[k] *= cs[k];
+            ++k;
+
+            result.residual = std::abs(g[k]);
+            result.converged = result.residual <= target;
+            ++result.iterations;
+            if (options.monitor && !options.monitor(result.iterations, result.residual)) {
+                stopped = true;
+            }
+            if (result.converged || stopped || hNext == T(0)) {
+                break;
+            }
+        }
+        // x += M^-1 V y, where H y = g (upper triangular k x k)
+        for (size_t i = k; i-- > 0;) {
+            T sum = g[i];
+            for (size_t j = i + 1; j < k; ++j) {
+                sum -= H.at(i, j) * y[j];
+            }
+            y[i] = sum / H.at(i, i);
+        }
+        detail::forEachChunk(policy, n, detail::vectorChunkSize, [&](size_t first, size_t last) {
+            for (size_t l = first; l < last; ++l) {
+                T sum = 0;
+                for (size_t i = 0; i < k; ++i) {
+                    sum += y[i] * V[i][l];
+                }
+                w[l] = sum;
+            }
+        });
+        preconditioner.apply(w, z);
+        detail::forEachChunk(policy, n, detail::vectorChunkSize, [&](size_t first, size_t last) {
+            for (size_t l = first; l < last; ++l) {
+                x[l] += z[l];
+            }
+        });
+        detail::residual(policy, A, x, b, r);
+        result.residual = detail::norm(policy, r);
+        result.converged = result.residual <= target;
+    }
+    return result;
+}
+
+/**
+ * Solves A x = b with restarted GMRES sequentially.
+ */
+template <typename T, typename Preconditioner = IdentityPreconditioner>
+IterativeResult<T> gmres(const SparseMatrix<T>& A, const std::vector<T>& b,
+                         const Preconditioner& preconditioner = {}, const IterativeOptions<T>& options = {}) {
+    return gmres(execution::seq, A, b, preconditioner, options);
+}
+
+/**
+ * Computes sparse matrix-vector product A * x.
+ * @param policy - execution policy; with parallel ones, blocks of rows are processed on the thread pool.
+ */
+template <typename Policy, typename T, typename = std::enable_if_t<execution::isExecutionPolicy<Policy>>>
+std::vector<T> multiply(Policy policy, const SparseMatrix<T>& A, const std::vector<T>& x) {
+    if (A.columns() != x.size()) {
+        throw std::invalid_argument("multiply: matrix and vector sizes do not match");
+    }
+    std::vector<T> y (A.rows());
+    detail::spmv(policy, A, x.data(), y.data());
+    return y;
+}
+
+/**
+ * Computes sparse matrix-vector product A * x sequentially.
+ */
+template <typename T>
+std::vector<T> multiply(const SparseMatrix<T>& A, const std::vector<T>& x) {
+    return multiply(execution::seq, A, x);
+}
+
+} // nya
+
+#endif //NUMUTILS_SPARSE_HPP
@@ -0,0 +1,184 @@
+#ifndef NUMUTILS_SUMMATION_HPP
+#define NUMUTILS_SUMMATION_HPP
+
+#include <cstddef>
+
+namespace nya {
+
+/**
+ * Accumulators used to sum terms of numerical integrals.
+ *
+ * Every accumulator provides add(x) and result(). Value type T may be either scalar or Batch (then sums are kept
+ * per lane); only +, - and default construction (to zero) are required from it.
+ */
+
+/**
+ * Plain running sum. Fastest; rounding error grows as O(n) with number of terms.
+ * @tparam T - type of summed values.
+ */
+template <typename T>
+struct NaiveSum {
+    T sum {};
+
+    inline void add(T x) noexcept {
+        sum += x;
+    }
+
+    inline T result() const noexcept {
+        return sum;
+    }
+};
+
+/**
+ * Kahan compensated summation. Rounding error is O(1) as long as terms are of the same sign.
+ * @tparam T - type of summed values.
+ */
+template <typename T>
+struct KahanSum {
+    T sum {};
+    T compensation {};
+
+    inline void add(T x) noexcept {
+        const T y = x - compensation;
+        const T t = sum + y;
+        compensation = (t - sum) - y;
+        sum = t;
+    }
+
+    inline T result() const noexcept {
+        return sum;
+    }
+};
+
+/**
+ * Neumaier (improved Kahan-Babuska) summation. Rounding error is O(1) for terms of any sign and magnitude.
+ *
+ * Exact error of each addition is computed with branch-free TwoSum instead of comparing magnitudes, so that it
+ * works on batches too. Errors are themselves summed with compensation (second-order scheme by Klein), otherwise
+ * for long sums in single precision the accumulated correction loses accuracy of its own.
+ * @tparam T - type of summed values.
+ */
+template <typename T>
+struct NeumaierSum {
+    T sum {};
+    T compensation {};
+    T secondOrder {};
+
+    inline void add(T x) noexcept {
+        T error;
+        sum = twoSum(sum, x, error);
+        T secondError;
+        compensation = twoSum(compensation, error, secondError);
+        secondOrder += secondError;
+    }
+
+    inline T result() const noexcept {
+        return sum + (compensation + secondOrder);
+    }
+
+private:
+    /**
+     * Returns a + b, and its rounding error in error.
+     */
+    static inline T twoSum(T a, T b, T& error) noexcept {
+        const T s = a + b;
+        const T bPart = s - a;
+        error = (a - (s - bPart)) + (b - bPart);
+        return s;
+    }
+};
+
+/**
+ * Blocked pairwise (cascade) summation. Rounding error grows as O(log n), at nearly the cost of the naive sum.
+ *
+ * Terms are collected into blocks of blockSize, which are summed naively; block sums are then combined
+ * as in a binary counter, so that only O(log n) partial sums are stored.
+ * @tparam T - type of summed values.
+ */
+template <typename T>
+struct PairwiseSum {
+    static constexpr size_t blockSize = 64;
+    static constexpr size_t maxLevels = 64;
+
+    T block[blockSize];
+    size_t blockFill = 0;
+    T levels[maxLevels];
+    size_t occupied = 0; // bit i is set if levels[i] holds a sum of 2^i blocks
+
+    inline void add(T x) noexcept {
+        block[blockFill++] = x;
+        if (blockFill == blockSize) {
+            T carry = sumBlock();
+            blockFill = 0;
+            size_t level = 0;
+            for (; occupied & (size_t(1) << level); ++level) {
+                carry = levels[level] + carry;
+                occupied &= ~(size_t(1) << level);
+            }
+            levels[level] = carry;
+            occupied |= size_t(1) << level;
+        }
+    }
+
+    inline T result() const noexcept {
+        T total = sumBlock();
+        for (size_t level = 0; level < maxLevels; ++level) {
+            if (occupied & (size_t(1) << level)) {
+                total = levels[level] + total;
+            }
+        }
+        return total;
+    }
+
+private:
+    inline T sumBlock() const noexcept {
+        T total {};
+        for (size_t i = 0; i < blockFill; ++i) {
+            total += block[i];
+        }
+        return total;
+    }
+};
+
+/**
+ * Running mean and variance of a stream of values (Welford's algorithm).
+ *
+ * Statistics of separate parts of a stream can be merged (Chan et al.), so that parts may be processed
+ * concurrently and combined in a fixed order.
+ * @tparam T - floating point type.
+ */
+template <typename T>
+struct RunningStatistics {
+    size_t count = 0;
+    T mean = 0;
+    T m2 = 0; // sum of squared deviations from the mean
+
+    inline void add(T x) noexcept {
+        ++count;
+        const T delta = x - mean;
+        mean += delta / count;
+        m2 += delta * (x - mean);
+    }
+
+    inline void merge(const RunningStatistics& other) noexcept {
+        if (other.count == 0) {
+            return;
+        }
+        const size_t total = count + other.count;
+        const T delta = other.mean - mean;
+        mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * (static_cast<T>(count) * other.count / total);
+        count = total;
+    }
+
+    /**
+     * @brief Returns unbiased sample variance.
+     */
+    inline T variance() const noexcept {
+        return count > 1 ? m2 / (count - 1) : 0;
+    }
+};
+
+} // nya
+
+#endif //NUMUTILS_SUMMATION_HPP
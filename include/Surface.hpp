@@ -1,10 +1,70 @@
 #ifndef NUMUTILS_SURFACE_HPP
 #define NUMUTILS_SURFACE_HPP
 
+#include <cstddef>
+#include <utility>
 #include <vector>
 
+#include "Memory.hpp"
+
 namespace nya {
 
+/**
+ * Non-owning strided view of a matrix or its block: element (i, j) is data[i * rowStride + j * columnStride].
+ *
+ * Rows and columns follow Surface::at(): view of a surface has sizeX() rows and sizeY() columns regardless of
+ * storage order (unlike Surface::rowCount() and columnCount(), which count storage lines). Views are cheap to
+ * copy and pass by value; rows, columns, blocks and transposition are views of the same memory.
+ * @tparam T - type of elements (const-qualified for read-only views).
+ */
+template <typename T>
+struct SurfaceView {
+    T* data;
+    size_t rows;
+    size_t columns;
+    size_t rowStride;
+    size_t columnStride;
+
+    inline T& operator()(size_t i, size_t j) const noexcept {
+        return data[i * rowStride + j * columnStride];
+    }
+
+    inline T& at(size_t i, size_t j) const noexcept {
+        return (*this)(i, j);
+    }
+
+    inline operator SurfaceView<const T>() const noexcept {
+        return { data, rows, columns, rowStride, columnStride };
+    }
+
+    inline SurfaceView block(size_t i, size_t j, size_t blockRows, size_t blockColumns) const noexcept {
+        return { &(*this)(i, j), blockRows, blockColumns, rowStride, columnStride };
+    }
+
+    inline SurfaceView row(size_t i) const noexcept {
+        return block(i, 0, 1, columns);
+    }
+
+    inline SurfaceView column(size_t j) const noexcept {
+        return block(0, j, rows, 1);
+    }
+
+    inline SurfaceView transposed() const noexcept {
+        return { data, columns, rows, columnStride, rowStride };
+    }
+};
+
+/**
+ * Two-dimensional array of sizeX() x sizeY() elements at(x, y), stored row-major (elements with consecutive y
+ * are adjacent) or column-major (elements with consecutive x are adjacent).
+ *
+ * rowCount() and columnCount() describe storage: for column-major surface rowCount() is sizeY(). Views
+ * (view(), xLine(), yLine(), block()) are in terms of x and y for both storage orders.
+ *
+ * std::vector base is the storage itself. For surfaces made by padded() it includes padding at the end of every
+ * storage line, so size(), begin() .. end() and data() indexing cover more than sizeX() * sizeY() elements; use
+ * at() or views to visit elements of such surfaces. operator== compares elements only.
+ */
 template< typename T, bool rowMajor = true, typename Alloc = std::allocator<T> >
 class Surface : public std::vector<T, Alloc> {
 
@@ -16,53 +76,75 @@ protected:
 
     size_type xSize;
     size_type ySize;
+    size_type stride; // distance between starts of consecutive storage rows (columns, if not rowMajor)
+
+    Surface(size_type xSize, size_type ySize, size_type stride, const T& __value, const allocator_type& __a)
+        : vector(stride * (rowMajor ? xSize : ySize), __value, __a), xSize(xSize), ySize(ySize), stride(stride) {
+    }
 
 public:
-    Surface() : vector() {
+    Surface() : vector(), xSize(0), ySize(0), stride(0) {
     }
 
     explicit Surface(const allocator_type& __a)
-        : vector(__a) {
+        : vector(__a), xSize(0), ySize(0), stride(0) {
     }
 
     Surface(size_type xSize, size_type ySize)
-        : vector(xSize * ySize), xSize(xSize), ySize(ySize) {
+        : vector(xSize * ySize), xSize(xSize), ySize(ySize), stride(rowMajor ? ySize : xSize) {
     }
 
     Surface(size_type xSize, size_type ySize, const allocator_type& __a)
-        : vector(xSize * ySize, __a), xSize(xSize), ySize(ySize) {
+        : vector(xSize * ySize, __a), xSize(xSize), ySize(ySize), stride(rowMajor ? ySize : xSize) {
     }
 
     Surface(size_type xSize, size_type ySize, const T& __value, const allocator_type& __a = allocator_type())
-        : vector(xSize * ySize, __value, __a), xSize(xSize), ySize(ySize) {
+        : vector(xSize * ySize, __value, __a), xSize(xSize), ySize(ySize), stride(rowMajor ? ySize : xSize) {
     }
 
     Surface(const Surface& __x)
-        : vector(__x), xSize(__x.xSize), ySize(__x.ySize) {
+        : vector(__x), xSize(__x.xSize), ySize(__x.ySize), stride(__x.stride) {
     }
 
     Surface(Surface&& __x) noexcept
-        : vector(std::forward<Surface>(__x)), xSize(__x.xSize), ySize(__x.ySize) {
+        : vector(std::forward<Surface>(__x)), xSize(__x.xSize), ySize(__x.ySize), stride(__x.stride) {
     }
 
     Surface(const Surface& __x, const allocator_type& __a)
-        : vector(__x, __a), xSize(__x.xSize), ySize(__x.ySize) {
+        : vector(__x, __a), xSize(__x.xSize), ySize(__x.ySize), stride(__x.stride) {
     }
 
     Surface(Surface&& __x, const allocator_type& __a)
-        : vector(std::forward<Surface>(__x), __a), xSize(__x.xSize), ySize(__x.ySize) {
+        : vector(std::forward<Surface>(__x), __a), xSize(__x.xSize), ySize(__x.ySize), stride(__x.stride) {
+    }
+
+    /**
+     * Makes surface, whose storage rows (columns, if not rowMajor) are padded to a multiple of cache line, so that
+     * with aligned allocator (see AlignedSurface) every row starts at cache line boundary. Padding elements are
+     * initialized with value too.
+     */
+    static Surface padded(size_type xSize, size_type ySize, const T& __value = T(),
+                          const allocator_type& __a = allocator_type()) {
+        constexpr size_type lineElements = sizeof(T) <= cacheLineSize && cacheLineSize % sizeof(T) == 0
+                                           ? cacheLineSize / sizeof(T) : 1;
+        const size_type length = rowMajor ? ySize : xSize;
+        return Surface(xSize, ySize, (length + lineElements - 1) / lineElements * lineElements, __value, __a);
     }
 
-    inline Surface& operator=(const Surface& __x) noexcept {
+    inline Surface& operator=(const Surface& __x) {
         this->xSize = __x.xSize;
         this->ySize = __x.ySize;
-        return vector::operator=(__x);
+        this->stride = __x.stride;
+        vector::operator=(__x);
+        return *this;
     }
 
     inline Surface& operator=(Surface&& __x) noexcept {
         this->xSize = __x.xSize;
         this->ySize = __x.ySize;
-        return vector::operator=(std::forward<Surface>(__x));
+        this->stride = __x.stride;
+        vector::operator=(std::forward<Surface>(__x));
+        return *this;
     }
 
     /**
@@ -70,9 +152,9 @@ public:
      */
     inline T& at(size_type x, size_type y) noexcept {
         if constexpr (rowMajor) {
-            return *(vector::begin() + x * ySize + y);
+            return *(vector::begin() + x * stride + y);
         } else {
-            return *(vector::begin() + y * xSize + x);
+            return *(vector::begin() + y * stride + x);
         }
     }
 
@@ -81,9 +163,9 @@ public:
      */
     inline const T& at(size_type x, size_type y) const noexcept {
         if constexpr (rowMajor) {
-            return *(vector::begin() + x * ySize + y);
+            return *(vector::begin() + x * stride + y);
         } else {
-            return *(vector::begin() + y * xSize + x);
+            return *(vector::begin() + y * stride + x);
         }
     }
 
@@ -117,8 +199,95 @@ public:
         }
     }
 
+    /**
+     * @brief Returns distance between starts of consecutive storage rows (columns, if not rowMajor), in elements.
+     */
+    inline size_type leadingDimension() const noexcept {
+        return this->stride;
+    }
+
+    /**
+     * @brief Returns view of the whole surface: element (x, y) of the view is at(x, y).
+     */
+    inline SurfaceView<T> view() noexcept {
+        return { vector::data(), xSize, ySize, rowMajor ? stride : 1, rowMajor ? 1 : stride };
+    }
+
+    inline SurfaceView<const T> view() const noexcept {
+        return { vector::data(), xSize, ySize, rowMajor ? stride : 1, rowMajor ? 1 : stride };
+    }
+
+    /**
+     * @brief Returns 1 x sizeY() view of elements at(x, 0) .. at(x, sizeY() - 1) (a storage row only if rowMajor).
+     */
+    inline SurfaceView<T> xLine(size_type x) noexcept {
+        return view().row(x);
+    }
+
+    inline SurfaceView<const T> xLine(size_type x) const noexcept {
+        return view().row(x);
+    }
+
+    /**
+     * @brief Returns sizeX() x 1 view of elements at(0, y) .. at(sizeX() - 1, y) (a storage column only if rowMajor).
+     */
+    inline SurfaceView<T> yLine(size_type y) noexcept {
+        return view().column(y);
+    }
+
+    inline SurfaceView<const T> yLine(size_type y) const noexcept {
+        return view().column(y);
+    }
+
+    /**
+     * @brief Returns xCount x yCount view of elements at(x + i, y + j).
+     */
+    inline SurfaceView<T> block(size_type x, size_type y, size_type xCount, size_type yCount) noexcept {
+        return view().block(x, y, xCount, yCount);
+    }
+
+    inline SurfaceView<const T> block(size_type x, size_type y, size_type xCount, size_type yCount) const noexcept {
+        return view().block(x, y, xCount, yCount);
+    }
+
 };
 
+/**
+ * Compares sizes and elements of surfaces, ignoring padding.
+ */
+template <typename T, bool rowMajor, typename Alloc>
+bool operator==(const Surface<T, rowMajor, Alloc>& a, const Surface<T, rowMajor, Alloc>& b) {
+    if (a.sizeX() != b.sizeX() || a.sizeY() != b.sizeY()) {
+        return false;
+    }
+    for (size_t x = 0; x < a.sizeX(); ++x) {
+        for (size_t y = 0; y < a.sizeY(); ++y) {
+            if (!(a.at(x, y) == b.at(x, y))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename T, bool rowMajor, typename Alloc>
+bool operator!=(const Surface<T, rowMajor, Alloc>& a, const Surface<T, rowMajor, Alloc>& b) {
+    return !(a == b);
+}
+
+/**
+ * Surface with cache line aligned storage; with Surface::padded(), every storage row is aligned.
+ */
+template <typename T, bool rowMajor = true>
+using AlignedSurface = Surface<T, rowMajor, AlignedAllocator<T>>;
+
+/**
+ * Surface allocated from an Arena (the calling thread's one by default), for temporaries, which should not
+ * outlive the enclosing ArenaScope.
+ */
+template <typename T, bool rowMajor = true>
+using ArenaSurface = Surface<T, rowMajor, ArenaAllocator<T>>;
+
 } // nya
 
 #endif //NUMUTILS_SURFACE_HPP
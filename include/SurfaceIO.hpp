@@ -0,0 +1,403 @@
+#ifndef NUMUTILS_SURFACEIO_HPP
+#define NUMUTILS_SURFACEIO_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NUMUTILS_HAS_MMAP 1
+#endif
+
+#include "Surface.hpp"
+
+namespace nya {
+
+/**
+ * Binary file format of Surface: 64-byte header followed by elements in storage order of the surface, raw and in
+ * native byte order. Storage rows (columns, if not rowMajor) are leadingDimension elements apart, data starts
+ * at dataOffset (cache line aligned, so that mapped data is aligned too).
+ */
+struct SurfaceFileHeader {
+    static constexpr char signature[8] = { 'N', 'Y', 'A', 'S', 'U', 'R', 'F', '\0' };
+    static constexpr uint32_t currentVersion = 1;
+    static constexpr uint32_t nativeByteOrder = 0x01020304;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t dtype;
+    uint32_t elementSize;
+    uint64_t xSize;
+    uint64_t ySize;
+    uint64_t leadingDimension;
+    uint64_t dataOffset;
+    uint8_t rowMajor;
+    uint8_t reserved[7];
+};
+
+static_assert(sizeof(SurfaceFileHeader) == 64, "Surface file header should take exactly 64 bytes");
+
+namespace detail {
+
+/**
+ * Codes of element types in SurfaceFileHeader::dtype.
+ */
+template <typename T> struct SurfaceDtype;
+template <> struct SurfaceDtype<float> : std::integral_constant<uint32_t, 1> {};
+template <> struct SurfaceDtype<double> : std::integral_constant<uint32_t, 2> {};
+template <> struct SurfaceDtype<int32_t> : std::integral_constant<uint32_t, 3> {};
+template <> struct SurfaceDtype<int64_t> : std::integral_constant<uint32_t, 4> {};
+template <> struct SurfaceDtype<uint32_t> : std::integral_constant<uint32_t, 5> {};
+template <> struct SurfaceDtype<uint64_t> : std::integral_constant<uint32_t, 6> {};
+
+template <typename T, bool rowMajor>
+SurfaceFileHeader makeSurfaceHeader(uint64_t xSize, uint64_t ySize) noexcept {
+    SurfaceFileHeader header {};
+    std::memcpy(header.magic, SurfaceFileHeader::signature, sizeof(header.magic));
+    header.version = SurfaceFileHeader::currentVersion;
+    header.byteOrder = SurfaceFileHeader::nativeByteOrder;
+    header.dtype = SurfaceDtype<T>::value;
+    header.elementSize = sizeof(T);
+    header.xSize = xSize;
+    header.ySize = ySize;
+    header.leadingDimension = rowMajor ? ySize : xSize;
+    header.dataOffset = sizeof(SurfaceFileHeader);
+    header.rowMajor = rowMajor;
+    return header;
+}
+
+/**
+ * Checks that header describes surface of T with given layout, stored in a file of given size.
+ * @throws std::runtime_error otherwise.
+ */
+template <typename T, bool rowMajor>
+void validateSurfaceHeader(const SurfaceFileHeader& header, uint64_t fileSize, const std::string& path) {
+    const auto fail = [&path](const char* reason) {
+        throw std::runtime_error("Invalid surface file " + path + ": " + reason);
+    };
+    if (std::memcmp(header.magic, SurfaceFileHeader::signature, sizeof(header.magic)) != 0) {
+        fail("bad signature");
+    }
+    if (header.version != SurfaceFileHeader::currentVersion) {
+        fail("unsupported version");
+    }
+    if (header.byteOrder != SurfaceFileHeader::nativeByteOrder) {
+        fail("byte order differs from native");
+    }
+    if (header.dtype != SurfaceDtype<T>::value || header.elementSize != sizeof(T)) {
+        fail("element type differs from requested");
+    }
+    if (static_cast<bool>(header.rowMajor) != rowMajor) {
+        fail("storage order differs from requested");
+    }
+    const uint64_t lines = rowMajor ? header.xSize : header.ySize;
+    const uint64_t length = rowMajor ? header.ySize : header.xSize;
+    if (header.leadingDimension < length || header.dataOffset % alignof(T) != 0) {
+        fail("inconsistent layout");
+    }
+    // data spans (lines - 1) * leadingDimension + length elements, whose size in bytes should fit in uint64_t
+    const uint64_t maxElements = std::numeric_limits<uint64_t>::max() / sizeof(T);
+    if (length > maxElements || (lines > 1 && header.leadingDimension != 0
+                                   && lines - 1 > (maxElements - length) / header.leadingDimension)) {
+        fail("sizes are too large");
+    }
+    const uint64_t elements = lines == 0 ? 0 : (lines - 1) * header.leadingDimension + length;
+    if (header.dataOffset > fileSize || fileSize - header.dataOffset < elements * sizeof(T)) {
+        fail("file is truncated");
+    }
+}
+
+} // detail
+
+/**
+ * Writes surface, which is produced piece by piece, to a file in SurfaceFileHeader format.
+ *
+ * Elements are appended in storage order (rows of a rowMajor surface, columns otherwise) through a buffered
+ * stream, so the surface never needs to be in memory at once, e.g. when tabulating a field larger than RAM.
+ * @tparam T - type of elements.
+ * @tparam rowMajor - storage order of the surface.
+ */
+template <typename T, bool rowMajor = true>
+class SurfaceWriter {
+    std::ofstream out_;
+    std::string path_;
+    uint64_t expected_;
+    uint64_t written_ = 0;
+
+public:
+    /**
+     * Creates (or truncates) file and writes header of xSize x ySize surface.
+     * @throws std::runtime_error if file can not be opened.
+     */
+    SurfaceWriter(const std::string& path, size_t xSize, size_t ySize)
+        : out_(path, std::ios::binary | std::ios::trunc), path_(path), expected_(uint64_t(xSize) * ySize) {
+        if (!out_) {
+            throw std::runtime_error("Can not open " + path + " for writing");
+        }
+        const auto header = detail::makeSurfaceHeader<T, rowMajor>(xSize, ySize);
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    SurfaceWriter(SurfaceWriter&&) noexcept = default;
+
+    ~SurfaceWriter() {
+        if (out_.is_open()) {
+            out_.close();
+        }
+    }
+
+    /**
+     * Appends count elements, continuing storage order where the previous call stopped.
+     * @throws std::runtime_error on write error or if more elements than the surface holds are written.
+     */
+    void write(const T* values, size_t count) {
+        if (written_ + count > expected_) {
+            throw std::runtime_error("Too many elements written to " + path_);
+        }
+        out_.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(count * sizeof(T)));
+        if (!out_) {
+            throw std::runtime_error("Can not write to " + path_);
+        }
+        written_ += count;
+    }
+
+    /**
+     * Appends elements of a view (e.g. a block of rows of a rowMajor surface) in storage order.
+     */
+    void write(SurfaceView<const T> view) {
+        if constexpr (rowMajor) {
+            for (size_t i = 0; i < view.rows; ++i) {
+                writeLine(view.row(i));
+            }
+        } else {
+            for (size_t j = 0; j < view.columns; ++j) {
+                writeLine(view.column(j));
+            }
+        }
+    }
+
+    inline uint64_t written() const noexcept {
+        return written_;
+    }
+
+    /**
+     * Flushes and closes the file.
+     * @throws std::runtime_error if not all elements were written or on write error.
+     */
+    void close() {
+        out_.close();
+        if (written_ != expected_) {
+            throw std::runtime_error("Surface written to " + path_ + " is incomplete");
+        }
+        if (!out_) {
+            throw std::runtime_error("Can not write to " + path_);
+        }
+    }
+
+private:
+    void writeLine(SurfaceView<const T> line) {
+        const size_t count = line.rows * line.columns;
+        if (count == 1 || (rowMajor ? line.columnStride : line.rowStride) == 1) {
+            write(line.data, count);
+        } else {
+            for (size_t k = 0; k < count; ++k) {
+                write(rowMajor ? &line(0, k) : &line(k, 0), 1);
+            }
+        }
+    }
+};
+
+/**
+ * Writes surface to a file in SurfaceFileHeader format (padding of rows is dropped).
+ * @throws std::runtime_error on I/O error.
+ */
+template <typename T, bool rowMajor, typename Alloc>
+void writeSurface(const std::string& path, const Surface<T, rowMajor, Alloc>& surface) {
+    SurfaceWriter<T, rowMajor> writer { path, surface.sizeX(), surface.sizeY() };
+    writer.write(surface.view());
+    writer.close();
+}
+
+/**
+ * Read-only surface stored in a file, mapped into memory.
+ *
+ * Opening does not read the data: pages are loaded by the OS on first access (and shared between processes
+ * mapping the same file), so opening a table of any size is instant and costs no heap memory. On platforms
+ * without mmap the data is read into memory instead.
+ * @tparam T - type of elements, should match the file.
+ * @tparam rowMajor - storage order, should match the file.
+ */
+template <typename T, bool rowMajor = true>
+class MappedSurface {
+    const T* data_ = nullptr;
+    size_t xSize_ = 0;
+    size_t ySize_ = 0;
+    size_t stride_ = 0;
+#ifdef NUMUTILS_HAS_MMAP
+    void* mapping_ = nullptr;
+    size_t mappingSize_ = 0;
+#else
+    std::vector<char> buffer_;
+#endif
+
+public:
+    /**
+     * Maps file written by writeSurface or SurfaceWriter.
+     * @throws std::runtime_error if file can not be opened, or its header does not match T and rowMajor.
+     */
+    explicit MappedSurface(const std::string& path) {
+        SurfaceFileHeader header;
+#ifdef NUMUTILS_HAS_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Can not open " + path);
+        }
+        struct stat status;
+        if (::fstat(fd, &status) != 0 || static_cast<uint64_t>(status.st_size) < sizeof(header)) {
+            ::close(fd);
+            throw std::runtime_error("Invalid surface file " + path + ": file is truncated");
+        }
+        const auto fileSize = static_cast<uint64_t>(status.st_size);
+        mappingSize_ = static_cast<size_t>(fileSize);
+        mapping_ = ::mmap(nullptr, mappingSize_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping_ == MAP_FAILED) {
+            mapping_ = nullptr;
+            throw std::runtime_error("Can not map " + path);
+        }
+        const char* bytes = static_cast<const char*>(mapping_);
+#else
+        std::ifstream in (path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Can not open " + path);
+        }
+        buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        if (buffer_.size() < sizeof(header)) {
+            throw std::runtime_error("Invalid surface file " + path + ": file is truncated");
+        }
+        const char* bytes = buffer_.data();
+        const auto fileSize = static_cast<uint64_t>(buffer_.size());
+#endif
+        std::memcpy(&header, bytes, sizeof(header));
+        try {
+            detail::validateSurfaceHeader<T, rowMajor>(header, fileSize, path);
+        } catch (...) {
+            unmap();
+            throw;
+        }
+        data_ = reinterpret_cast<const T*>(bytes + header.dataOffset);
+        xSize_ = static_cast<size_t>(header.xSize);
+        ySize_ = static_cast<size_t>(header.ySize);
+        stride_ = static_cast<size_t>(header.leadingDimension);
+    }
+
+    MappedSurface(const MappedSurface&) = delete;
+    MappedSurface& operator=(const MappedSurface&) = delete;
+
+    MappedSurface(MappedSurface&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedSurface& operator=(MappedSurface&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            xSize_ = other.xSize_;
+            ySize_ = other.ySize_;
+            stride_ = other.stride_;
+#ifdef NUMUTILS_HAS_MMAP
+            mapping_ = std::exchange(other.mapping_, nullptr);
+            mappingSize_ = std::exchange(other.mappingSize_, 0);
+#else
+            buffer_ = std::move(other.buffer_);
+#endif
+        }
+        return *this;
+    }
+
+    ~MappedSurface() {
+        unmap();
+    }
+
+    inline const T& at(size_t x, size_t y) const noexcept {
+        if constexpr (rowMajor) {
+            return data_[x * stride_ + y];
+        } else {
+            return data_[y * stride_ + x];
+        }
+    }
+
+    inline size_t sizeX() const noexcept {
+        return xSize_;
+    }
+
+    inline size_t sizeY() const noexcept {
+        return ySize_;
+    }
+
+    inline size_t leadingDimension() const noexcept {
+        return stride_;
+    }
+
+    inline const T* data() const noexcept {
+        return data_;
+    }
+
+    /**
+     * @brief Returns view of the whole surface: element (x, y) of the view is at(x, y).
+     */
+    inline SurfaceView<const T> view() const noexcept {
+        return { data_, xSize_, ySize_, rowMajor ? stride_ : 1, rowMajor ? 1 : stride_ };
+    }
+
+    /**
+     * @brief Copies mapped data into a Surface.
+     */
+    Surface<T, rowMajor> load() const {
+        Surface<T, rowMajor> surface (xSize_, ySize_);
+        for (size_t x = 0; x < xSize_; ++x) {
+            for (size_t y = 0; y < ySize_; ++y) {
+                surface.at(x, y) = at(x, y);
+            }
+        }
+        return surface;
+    }
+
+private:
+    void unmap() noexcept {
+#ifdef NUMUTILS_HAS_MMAP
+        if (mapping_ != nullptr) {
+            ::munmap(mapping_, mappingSize_);
+            mapping_ = nullptr;
+        }
+#else
+        buffer_.clear();
+#endif
+        data_ = nullptr;
+    }
+};
+
+/**
+ * Reads surface from a file in SurfaceFileHeader format.
+ * @throws std::runtime_error if file can not be read, or its header does not match T and rowMajor.
+ */
+template <typename T, bool rowMajor = true>
+Surface<T, rowMajor> readSurface(const std::string& path) {
+    return MappedSurface<T, rowMajor>(path).load();
+}
+
+} // nya
+
+#endif //NUMUTILS_SURFACEIO_HPP
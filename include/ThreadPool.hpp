@@ -0,0 +1,227 @@
+#ifndef NUMUTILS_THREADPOOL_HPP
+#define NUMUTILS_THREADPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace nya {
+
+/**
+ * Execution policies, used to select serial or parallel versions of algorithms.
+ */
+namespace execution {
+
+struct SequencedPolicy {};
+struct ParallelPolicy {};
+struct ParallelUnsequencedPolicy {};
+
+/**
+ * Run on the calling thread only.
+ */
+constexpr SequencedPolicy seq {};
+
+/**
+ * Split work into chunks and run them on the shared thread pool.
+ */
+constexpr ParallelPolicy par {};
+
+/**
+ * Same as par, but additionally allows chunks to be vectorized.
+ */
+constexpr ParallelUnsequencedPolicy par_unseq {};
+
+template <typename Policy>
+constexpr bool isExecutionPolicy = std::is_same_v<Policy, SequencedPolicy>
+                                || std::is_same_v<Policy, ParallelPolicy>
+                                || std::is_same_v<Policy, ParallelUnsequencedPolicy>;
+
+template <typename Policy>
+constexpr bool isParallelPolicy = std::is_same_v<Policy, ParallelPolicy>
+                               || std::is_same_v<Policy, ParallelUnsequencedPolicy>;
+
+} // execution
+
+/**
+ * Simple fixed-size thread pool with a single FIFO task queue.
+ */
+class ThreadPool {
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable wakeUp_;
+    bool stopping_ = false;
+
+    void work() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock { mutex_ };
+                wakeUp_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                if (stopping_ && tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+public:
+    /**
+     * @param threads - number of worker threads. 0 means one per hardware thread.
+     */
+    explicit ThreadPool(size_t threads = 0) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        workers_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { work(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard lock { mutex_ };
+            stopping_ = true;
+        }
+        wakeUp_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Returns number of worker threads.
+     */
+    inline size_t size() const noexcept {
+        return workers_.size();
+    }
+
+    /**
+     * Schedules task for execution.
+     * @param task - function object without arguments.
+     * @return future holding the result of the task.
+     */
+    template <typename F>
+    auto submit(F task) -> std::future<std::invoke_result_t<F>> {
+        auto packaged = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::move(task));
+        auto result = packaged->get_future();
+        {
+            std::lock_guard lock { mutex_ };
+            tasks_.emplace_back([packaged] { (*packaged)(); });
+        }
+        wakeUp_.notify_one();
+        return result;
+    }
+
+    /**
+     * @brief Returns process-wide pool, used by parallel execution policies.
+     */
+    static ThreadPool& instance() {
+        static ThreadPool pool;
+        return pool;
+    }
+};
+
+/**
+ * Calls body(i) for every i in [0, count) using the thread pool.
+ *
+ * The calling thread takes part in the work, so nested calls (e.g. from inside of another parallelFor) can not
+ * deadlock: helpers which were not started by the time all indices are taken simply do nothing.
+ * Exceptions thrown by body are rethrown in the calling thread (the first one wins).
+ */
+template <typename F>
+void parallelFor(size_t count, F&& body, ThreadPool& pool = ThreadPool::instance()) {
+    if (count == 0) {
+        return;
+    }
+    const size_t helpers = std::min(pool.size(), count - 1);
+    if (helpers == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    struct State {
+        std::atomic<size_t> next { 0 };
+        size_t active = 0;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    auto state = std::make_shared<State>();
+    auto* fn = &body;
+    const auto run = [count, fn](State& s) {
+        for (size_t i; (i = s.next++) < count;) {
+            try {
+                (*fn)(i);
+            } catch (...) {
+                std::lock_guard lock { s.mutex };
+                if (!s.error) {
+                    s.error = std::current_exception();
+                }
+                s.next = count;
+            }
+        }
+    };
+
+    for (size_t h = 0; h < helpers; ++h) {
+        pool.submit([state, run] {
+            {
+                std::lock_guard lock { state->mutex };
+                ++state->active;
+            }
+            run(*state);
+            {
+                std::lock_guard lock { state->mutex };
+                --state->active;
+            }
+            state->done.notify_all();
+        });
+    }
+    run(*state);
+
+    std::unique_lock lock { state->mutex };
+    state->done.wait(lock, [&state] { return state->active == 0; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+namespace detail {
+
+/**
+ * Calls body(i) for every i in [0, count): with parallelFor if policy is parallel, in order otherwise.
+ */
+template <typename Policy, typename F>
+void forEachIndex(Policy, size_t count, F&& body) {
+    if constexpr (execution::isParallelPolicy<Policy>) {
+        parallelFor(count, body);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+    }
+}
+
+} // detail
+
+} // nya
+
+#endif //NUMUTILS_THREADPOOL_HPP
@@ -0,0 +1,53 @@
+#include "TestUtils.hpp"
+
+#include <NumericalUtils.hpp>
+
+TEST(AutoDiffTest, Taylor_Functions) {
+    // derivatives of g up to the third one, against nested dual numbers x0 + e1 + e2 + e3, whose coefficient
+    // of e1 * e2 * e3 is the third derivative
+    const auto g = [](auto x) {
+        using std::exp; using std::sin; using std::sqrt; using std::log; using std::pow; using std::tan;
+        return exp(sin(x)) / sqrt(x) + log(x) * pow(x, 1.5) - tan(x);
+    };
+    const double x0 = 0.7;
+    const auto series = g(nya::Taylor<double, 3>::variable(x0));
+    EXPECT_DOUBLE_EQ(series.value(), g(x0));
+
+    using Dual = nya::Dual<double>;
+    using Dual2 = nya::Dual<Dual>;
+    using Dual3 = nya::Dual<Dual2>;
+    Dual3 x = Dual3::variable(Dual2::variable(Dual::variable(x0)));
+    const auto nested = g(x);
+    EXPECT_NEAR(series.derivative(1), nested.a[1].a[0].a[0], 1e-12);
+    EXPECT_NEAR(series.derivative(2), nested.a[1].a[1].a[0], 1e-11);
+    EXPECT_NEAR(series.derivative(3), nested.a[1].a[1].a[1], 1e-10);
+}
+
+TEST(AutoDiffTest, D) {
+    const auto f = [](auto x, auto y) { using std::exp; using std::cos; return exp(2 * x) * cos(x * y); };
+    const double x = 0.3, y = 1.7;
+
+    EXPECT_NEAR(nya::D<nya::AutoDiff>(f)(x, y),
+                std::exp(2 * x) * (2 * std::cos(x * y) - y * std::sin(x * y)), 1e-14);
+    EXPECT_NEAR((nya::D<nya::AutoDiff, 1, 1>(f)(x, y)), -x * std::exp(2 * x) * std::sin(x * y), 1e-14);
+    EXPECT_NEAR((nya::D<nya::AutoDiff, 2, 1>(f)(x, y)), -x * x * std::exp(2 * x) * std::cos(x * y), 1e-14);
+    // finite differences are far less accurate
+    EXPECT_GT(std::abs(nya::D<nya::LFD1>(f)(x, y) - nya::D<nya::AutoDiff>(f)(x, y)), 1e-9);
+
+    // batches of points and functions not depending on the variable
+    using Batch2 = nya::Batch<double, 2>;
+    const auto batch = nya::D<nya::AutoDiff>(f)(Batch2 { { 0.3, 0.5 } }, Batch2::broadcast(y));
+    EXPECT_NEAR(batch[1], nya::D<nya::AutoDiff>(f)(0.5, y), 1e-14);
+    EXPECT_EQ(nya::D<nya::AutoDiff>([](auto) { return 1.0; })(x), 0.0);
+}
+
+TEST(AutoDiffTest, Galerkin) {
+    // y' - y = 0 with exact derivatives of trial functions
+    auto L = [](auto f) { return nya::sum(nya::D<nya::AutoDiff>(f), nya::negate(f)); };
+    auto rule = nya::QuadratureRule<double>::gaussLegendre(40, -1.0, 1.0);
+
+    auto y = nya::galerkin<nya::Euler>(L, nya::ChebyshevBasis<double> { 14 })(rule);
+    for (double x = -1.0; x <= 1.0; x += 0.25) {
+        EXPECT_NEAR(y(x) / y(0.0), std::exp(x), 1e-10);
+    }
+}
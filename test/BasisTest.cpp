@@ -0,0 +1,135 @@
+#include "TestUtils.hpp"
+
+#include <NumericalUtils.hpp>
+
+TEST(BasisTest, Chebyshev_EvalAll) {
+    const nya::ChebyshevBasis<double> basis { 30 };
+    ASSERT_EQ(basis.size(), 31);
+    std::vector<double> values (basis.size());
+    for (double x = -1.0; x <= 1.0; x += 0.05) {
+        basis.evalAll(x, values.data());
+        for (size_t n = 0; n < basis.size(); ++n) {
+            EXPECT_NEAR(values[n], std::cos(n * std::acos(x)), 1e-12);
+            EXPECT_NEAR(basis[n](x), values[n], 1e-12);
+        }
+    }
+
+    // batch of points
+    using Batch4 = nya::Batch<double, 4>;
+    Batch4 x;
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = -0.9 + 0.5 * i;
+    }
+    std::vector<Batch4> batchValues (basis.size());
+    basis.evalAll(x, batchValues.data());
+    for (size_t n = 0; n < basis.size(); ++n) {
+        for (size_t i = 0; i < x.size(); ++i) {
+            EXPECT_NEAR(batchValues[n][i], std::cos(n * std::acos(x[i])), 1e-12);
+        }
+    }
+}
+
+TEST(BasisTest, Chebyshev_Clenshaw) {
+    const nya::ChebyshevBasis<double> basis { 25 };
+    std::vector<double> coefs (basis.size());
+    for (size_t n = 0; n < coefs.size(); ++n) {
+        coefs[n] = 1.0 / (n + 1);
+    }
+    const auto series = nya::makeTrialFunction(basis, coefs);
+    const auto direct = nya::makeTrialFunction<double>(nya::chebyshevPolynomials(25), coefs);
+    for (double x = -1.0; x <= 1.0; x += 0.1) {
+        EXPECT_NEAR(series(x), direct(x), 1e-12);
+    }
+    const auto batch = series(nya::Batch<double, 2>::broadcast(0.3));
+    EXPECT_NEAR(batch[1], direct(0.3), 1e-12);
+}
+
+TEST(BasisTest, Chebyshev_Galerkin) {
+    // y' - y = 0; without boundary condition the solution is determined up to a factor
+    auto L = [](auto f) { return nya::sum(nya::D<nya::LFD1>(f), nya::negate(f)); };
+    auto rule = nya::QuadratureRule<double>::gaussLegendre(40, -1.0, 1.0);
+
+    auto y = nya::galerkin<nya::Euler>(L, nya::ChebyshevBasis<double> { 10 })(rule);
+    for (double x = -1.0; x <= 1.0; x += 0.25) {
+        EXPECT_NEAR(y(x) / y(0.0), std::exp(x), 1e-4);
+    }
+}
+
+TEST(BasisTest, Polynomial) {
+    const nya::PolynomialBasis<double> basis { 12 };
+    std::vector<double> values (basis.size());
+    basis.evalAll(1.3, values.data());
+    for (size_t n = 0; n < basis.size(); ++n) {
+        EXPECT_NEAR(values[n], std::pow(1.3, n), 1e-12 * values[n]);
+        EXPECT_NEAR(basis[n](1.3), values[n], 1e-12 * values[n]);
+    }
+
+    const std::vector<double> coefs { 1.0, -2.0, 0.5, 3.0 };
+    const auto series = nya::makeTrialFunction(basis, coefs);
+    const auto direct = nya::makeTrialFunction<double>(nya::polynomials(3), coefs);
+    EXPECT_NEAR(series(0.7), direct(0.7), 1e-14);
+    EXPECT_NEAR(series(-2.0), 1.0 + 4.0 + 2.0 - 24.0, 1e-14);
+}
+
+TEST(BasisTest, Tabulate) {
+    const auto series = nya::PolynomialBasis<double>(3).combination({ 1.0, -2.0, 0.5, 3.0 });
+    const auto range = nya::Range<double> { 0.0, 1003, 0.001 }; // not a multiple of batch size
+    std::vector<double> values (range.count());
+    const auto end = nya::tabulate<4>(series, range.begin(), range.end(), values.begin());
+    EXPECT_EQ(end, values.end());
+    size_t i = 0;
+    for (auto x : range) {
+        EXPECT_NEAR(values[i++], series(x), 1e-14);
+    }
+}
+
+TEST(BasisTest, Polynomial_Galerkin) {
+    auto L = [](auto f) { return nya::sum(nya::D<nya::LFD1>(f), nya::negate(f)); };
+    auto rule = nya::QuadratureRule<double>::gaussLegendre(20, 0.0, 1.0);
+    auto y = nya::galerkin<nya::Euler>(L, nya::PolynomialBasis<double> { 5 })(rule);
+    auto yFunctions = nya::galerkin<nya::Euler>(L, nya::polynomials(5))(rule);
+    EXPECT_NEAR(y(1.0), std::exp(1.0), 1e-4);
+    EXPECT_NEAR(y(0.3), yFunctions(0.3), 1e-12);
+}
+
+TEST(BasisTest, FunctionBasis) {
+    const auto basis = nya::makeBasis([](auto) { return 1; }, [](auto x) { return x; }, [](auto x) { return x * x; });
+    static_assert(basis.size() == 3);
+
+    double values[3];
+    basis.evalAll(2.0, values);
+    EXPECT_EQ(values[0], 1.0);
+    EXPECT_EQ(values[1], 2.0);
+    EXPECT_EQ(values[2], 4.0);
+
+    nya::Batch<double, 2> batchValues[3];
+    basis.evalAll(nya::Batch<double, 2>::broadcast(3.0), batchValues);
+    EXPECT_EQ(batchValues[0][1], 1.0);
+    EXPECT_EQ(batchValues[2][1], 9.0);
+
+    double visited = 0;
+    basis.visit(2, [&visited](const auto& f) { visited = f(3.0); });
+    EXPECT_EQ(visited, 9.0);
+
+    const auto doubled = basis.map([](auto f) { return [f](auto x) { return 2 * f(x); }; });
+    doubled.evalAll(2.0, values);
+    EXPECT_EQ(values[2], 8.0);
+
+    EXPECT_DOUBLE_EQ(basis.combination({ 1.0, 2.0, 3.0 })(2.0), 1.0 + 4.0 + 12.0);
+}
+
+TEST(BasisTest, FunctionBasis_Galerkin) {
+    auto L = [](auto f) { return nya::sum(nya::D<nya::LFD1>(f), nya::negate(f)); };
+    const auto basis = nya::makeBasis([](auto) { return 1.0; }, [](auto x) { return x; },
+                                      [](auto x) { return x * x; }, [](auto x) { return x * x * x; },
+                                      [](auto x) { return x * x * x * x; }, [](auto x) { return x * x * x * x * x; });
+    auto range = nya::discreteRange<4>(0.0, 1.0);
+
+    // same system as with equivalent vector of functions, both for tabulated and per-entry assembly
+    // (up to rounding, amplified by finite differences)
+    auto y = nya::galerkin<nya::Euler>(nya::execution::par, L, basis)(range);
+    EXPECT_NEAR(y(1.0), nya::galerkin<nya::Euler>(L, nya::polynomials(5))(range)(1.0), 1e-6);
+    auto coarse = nya::discreteRange<3>(0.0, 1.0);
+    EXPECT_NEAR(nya::galerkin<nya::RK4>(L, basis)(coarse)(0.5),
+                nya::galerkin<nya::RK4>(L, nya::polynomials(5))(coarse)(0.5), 1e-6);
+}
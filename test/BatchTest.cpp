@@ -0,0 +1,43 @@
+#include "TestUtils.hpp"
+
+#include <Batch.hpp>
+
+TEST(BatchTest, Arithmetic) {
+    nya::Batch<double, 4> x;
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = i + 1.0;
+    }
+    const auto y = 2.0 * x * x - x / 2 + 1;
+    for (size_t i = 0; i < x.size(); ++i) {
+        EXPECT_DOUBLE_EQ(y[i], 2.0 * x[i] * x[i] - x[i] / 2 + 1);
+    }
+    EXPECT_DOUBLE_EQ(x.sum(), 10.0);
+    using Batch4 = nya::Batch<double, 4>;
+    EXPECT_DOUBLE_EQ(Batch4::broadcast(1.5).sum(), 6.0);
+}
+
+TEST(BatchTest, Exp) {
+    nya::Batch<double, 4> x;
+    for (double v = -700.0; v < 700.0; v += 0.37) {
+        x[0] = v; x[1] = v / 7; x[2] = -v / 1000; x[3] = v / 3;
+        const auto e = exp(x);
+        for (size_t i = 0; i < x.size(); ++i) {
+            EXPECT_NEAR(e[i], std::exp(x[i]), 4e-16 * std::exp(x[i]));
+        }
+    }
+    // out of fast kernel range
+    x[0] = -1000.0; x[1] = 1000.0; x[2] = -710.0; x[3] = std::numeric_limits<double>::quiet_NaN();
+    const auto e = exp(x);
+    EXPECT_EQ(e[0], 0.0);
+    EXPECT_TRUE(std::isinf(e[1]));
+    EXPECT_DOUBLE_EQ(e[2], std::exp(-710.0));
+    EXPECT_TRUE(std::isnan(e[3]));
+}
+
+TEST(BatchTest, Batched_Mutable) {
+    auto counter = nya::batched<4>([calls = 0](auto x) mutable { ++calls; return x * calls; });
+    EXPECT_EQ(counter(1.0), 1.0);
+    EXPECT_EQ(counter(nya::Batch<double, 4>::broadcast(1.0))[3], 2.0);
+    const auto square = nya::batched<4>([](auto x) { return x * x; });
+    EXPECT_EQ(square(3.0), 9.0);
+}
@@ -0,0 +1,455 @@
+#include "TestUtils.hpp"
+
+#include <random>
+
+#include <NumericalUtils.hpp>
+
+namespace {
+
+nya::Surface<double> randomMatrix(size_t rows, size_t columns, unsigned seed) {
+    std::mt19937 gen { seed };
+    std::uniform_real_distribution<double> dist { -1.0, 1.0 };
+    nya::Surface<double> A (rows, columns);
+    for (auto& a : A) {
+        a = dist(gen);
+    }
+    return A;
+}
+
+std::vector<double> multiply(const nya::Surface<double>& A, const std::vector<double>& x) {
+    std::vector<double> y (A.rowCount());
+    for (size_t i = 0; i < A.rowCount(); ++i) {
+        for (size_t j = 0; j < A.columnCount(); ++j) {
+            y[i] += A.at(i, j) * x[j];
+        }
+    }
+    return y;
+}
+
+template <bool rowMajor>
+nya::Surface<double, rowMajor> relayout(const nya::Surface<double>& A) {
+    nya::Surface<double, rowMajor> result (A.sizeX(), A.sizeY());
+    for (size_t i = 0; i < A.sizeX(); ++i) {
+        for (size_t j = 0; j < A.sizeY(); ++j) {
+            result.at(i, j) = A.at(i, j);
+        }
+    }
+    return result;
+}
+
+template <bool rowMajorA, bool rowMajorB>
+void checkMultiply(const nya::Surface<double>& A, const nya::Surface<double>& B) {
+    const auto C = nya::multiply(nya::execution::par, relayout<rowMajorA>(A), relayout<rowMajorB>(B));
+    ASSERT_EQ(C.sizeX(), A.sizeX());
+    ASSERT_EQ(C.sizeY(), B.sizeY());
+    for (size_t i = 0; i < C.sizeX(); ++i) {
+        for (size_t j = 0; j < C.sizeY(); ++j) {
+            double expected = 0;
+            for (size_t k = 0; k < A.sizeY(); ++k) {
+                expected += A.at(i, k) * B.at(k, j);
+            }
+            EXPECT_NEAR(C.at(i, j), expected, 1e-12);
+        }
+    }
+}
+
+} // namespace
+
+TEST(LinearAlgebraTest, Multiply_MatrixMatrix) {
+    // sizes are not multiples of tile sizes
+    const auto A = randomMatrix(70, 150, 5);
+    const auto B = randomMatrix(150, 133, 6);
+    checkMultiply<true, true>(A, B);
+    checkMultiply<true, false>(A, B);
+    checkMultiply<false, true>(A, B);
+    checkMultiply<false, false>(A, B);
+    EXPECT_THROW(nya::multiply(A, A), std::invalid_argument);
+}
+
+TEST(LinearAlgebraTest, Multiply_MatrixVector) {
+    const auto A = randomMatrix(300, 45, 7);
+    std::vector<double> x (45);
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = std::cos(i + 0.5);
+    }
+    const auto expected = multiply(A, x);
+    const auto rowMajor = nya::multiply(nya::execution::par, A, x);
+    const auto columnMajor = nya::multiply(nya::execution::par, relayout<false>(A), x);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(rowMajor[i], expected[i], 1e-13);
+        EXPECT_NEAR(columnMajor[i], expected[i], 1e-13);
+    }
+}
+
+TEST(LinearAlgebraTest, SolveTriangular) {
+    const size_t n = 150;
+    auto A = randomMatrix(n, n, 8);
+    for (size_t i = 0; i < n; ++i) {
+        A.at(i, i) = 4.0 + i % 3; // keep it well conditioned
+    }
+    nya::Surface<double> lower (n, n), upper (n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            (i >= j ? lower : upper).at(i, j) = A.at(i, j);
+        }
+        upper.at(i, i) = A.at(i, i);
+    }
+    std::vector<double> expected (n);
+    for (size_t i = 0; i < n; ++i) {
+        expected[i] = 1.0 + i / 10.0;
+    }
+
+    const auto xl = nya::solveTriangular(nya::execution::par, nya::Triangle::Lower, A, multiply(lower, expected));
+    const auto xu = nya::solveTriangular(nya::Triangle::Upper, relayout<false>(A), multiply(upper, expected));
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(xl[i], expected[i], 1e-12);
+        EXPECT_NEAR(xu[i], expected[i], 1e-12);
+    }
+
+    // several right-hand sides, column-major
+    const auto X = randomMatrix(n, 3, 9);
+    auto B = relayout<false>(nya::multiply(lower, X));
+    nya::solveTriangular(nya::execution::par, nya::Triangle::Lower, A, B);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            EXPECT_NEAR(B.at(i, j), X.at(i, j), 1e-12);
+        }
+    }
+}
+
+TEST(LinearAlgebraTest, LU_Small) {
+    nya::Surface<double> A (3, 3);
+    const double values[] = { 0, 2, 1,
+                              1, 1, 1,
+                              2, 1, 3 };
+    std::copy(std::begin(values), std::end(values), A.begin());
+
+    const nya::LUFactorization<double> lu { A };
+    EXPECT_NEAR(lu.determinant(), -3.0, 1e-14);
+    const auto x = lu.solve(std::vector<double> { 3, 3, 6 });
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_NEAR(x[i], 1.0, 1e-14);
+    }
+}
+
+TEST(LinearAlgebraTest, LU_SeveralBlocks) {
+    // not a multiple of block size, so that the last panel is partial
+    const size_t n = 2 * nya::LUFactorization<double>::blockSize + 37;
+    const auto A = randomMatrix(n, n, 1);
+    std::vector<double> expected (n);
+    for (size_t i = 0; i < n; ++i) {
+        expected[i] = std::sin(i + 1.0);
+    }
+
+    const nya::LUFactorization<double> lu { A };
+    const auto x = lu.solve(multiply(A, expected));
+    const nya::LUFactorization<double> parallelLu { nya::execution::par, A };
+    const auto parallelX = parallelLu.solve(nya::execution::par, multiply(A, expected));
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(x[i], expected[i], 1e-10);
+        EXPECT_NEAR(parallelX[i], expected[i], 1e-10);
+    }
+}
+
+TEST(LinearAlgebraTest, LU_ManyRightHandSides) {
+    const size_t n = 100, m = 5;
+    const auto A = randomMatrix(n, n, 2);
+    const auto X = randomMatrix(n, m, 3);
+    nya::Surface<double> B (n, m);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < m; ++j) {
+            for (size_t k = 0; k < n; ++k) {
+                B.at(i, j) += A.at(i, k) * X.at(k, j);
+            }
+        }
+    }
+
+    const nya::LUFactorization<double> lu { A };
+    const auto solution = lu.solve(B);
+    for (size_t i = 0; i < n * m; ++i) {
+        EXPECT_NEAR(solution[i], X[i], 1e-10);
+    }
+}
+
+TEST(LinearAlgebraTest, LU_Singular) {
+    nya::Surface<double> A (3, 3, 1.0);
+    EXPECT_THROW(nya::LUFactorization<double> { A }, std::runtime_error);
+    EXPECT_THROW(nya::LUFactorization<double> { nya::Surface<double>(2, 3) }, std::invalid_argument);
+}
+
+TEST(LinearAlgebraTest, Eliminate) {
+    const size_t n = 80;
+    const auto A = randomMatrix(n, n, 4);
+    const std::vector<double> expected (n, 0.5);
+    const auto b = multiply(A, expected);
+
+    nya::Surface<double> augmented (n, n + 1);
+    for (size_t i = 0; i < n; ++i) {
+        std::copy_n(&A.at(i, 0), n, &augmented.at(i, 0));
+        augmented.at(i, n) = b[i];
+    }
+    const auto x = nya::eliminate(std::move(augmented));
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(x[i], 0.5, 1e-10);
+    }
+}
+
+TEST(LinearAlgebraTest, Eliminate_Errors) {
+    // singular systems throw instead of returning inf / NaN, for both dense and banded solvers
+    nya::Surface<double> dense (4, 5, 1.0);
+    EXPECT_THROW(nya::eliminate(std::move(dense)), std::runtime_error);
+    nya::Surface<double> tridiagonal (2, 3, 1.0);
+    EXPECT_THROW(nya::eliminate(nya::execution::par, std::move(tridiagonal)), std::runtime_error);
+
+    EXPECT_THROW(nya::eliminate(nya::Surface<double>(3, 3, 1.0)), std::invalid_argument);
+    EXPECT_THROW(nya::eliminate(nya::Surface<double>(3, 5, 1.0)), std::invalid_argument);
+}
+
+TEST(LinearAlgebraTest, Tridiagonal) {
+    const size_t n = 1000;
+    std::vector<double> sub (n - 1, -1.0), diagonal (n, 2.5), super (n - 1, -1.0), expected (n);
+    for (size_t i = 0; i < n; ++i) {
+        expected[i] = std::sin(i * 0.01);
+    }
+    std::vector<double> rhs (n);
+    for (size_t i = 0; i < n; ++i) {
+        rhs[i] = diagonal[i] * expected[i] + (i > 0 ? sub[i - 1] * expected[i - 1] : 0)
+                 + (i + 1 < n ? super[i] * expected[i + 1] : 0);
+    }
+    const auto x = nya::solveTridiagonal(sub, diagonal, super, rhs);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(x[i], expected[i], 1e-13);
+    }
+}
+
+TEST(LinearAlgebraTest, Banded) {
+    const size_t n = 300;
+    // random band matrix: not diagonally dominant, so pivoting is required
+    auto A = randomMatrix(n, n, 10);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            if (j + 2 < i || j > i + 3) {
+                A.at(i, j) = 0;
+            }
+        }
+    }
+    const auto band = nya::bandwidth(A);
+    EXPECT_EQ(band.lower, 2);
+    EXPECT_EQ(band.upper, 3);
+    EXPECT_EQ(nya::bandwidth(relayout<false>(A)).upper, 3);
+
+    std::vector<double> expected (n);
+    for (size_t i = 0; i < n; ++i) {
+        expected[i] = std::cos(i * 0.1);
+    }
+    const nya::BandMatrix<double> banded { A, band };
+    EXPECT_TRUE(banded.contains(5, 3));
+    EXPECT_FALSE(banded.contains(5, 2));
+    EXPECT_DOUBLE_EQ(banded.at(10, 13), A.at(10, 13));
+
+    const auto x = nya::BandLUFactorization<double> { banded }.solve(multiply(A, expected));
+    const auto y = nya::solveLinearSystem(A, multiply(A, expected));
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(x[i], expected[i], 1e-10);
+        EXPECT_NEAR(y[i], expected[i], 1e-10);
+    }
+}
+
+TEST(LinearAlgebraTest, SolveLinearSystem_Tridiagonal) {
+    const size_t n = 50;
+    nya::Surface<double, false> A (n, n);
+    for (size_t i = 0; i < n; ++i) {
+        A.at(i, i) = 4;
+        if (i > 0) {
+            A.at(i, i - 1) = 1;
+        }
+        if (i + 1 < n) {
+            A.at(i, i + 1) = -2;
+        }
+    }
+    std::vector<double> b (n, 3.0);
+    b.front() = 2.0;
+    b.back() = 5.0;
+    const auto x = nya::solveLinearSystem(nya::execution::par, A, b);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(x[i], 1.0, 1e-13);
+    }
+}
+
+TEST(LinearAlgebraTest, Transpose) {
+    // sizes with partial tiles and partial register blocks, within one tile and across several of them
+    for (const auto& [rows, columns] : { std::pair<size_t, size_t> { 150, 77 }, { 600, 600 }, { 777, 391 } }) {
+        const auto A = randomMatrix(rows, columns, 11);
+        const auto T = nya::transpose(nya::execution::par, A);
+        const auto colMajor = nya::convertLayout<false>(nya::execution::par, A);
+        const auto back = nya::convertLayout<true>(colMajor);
+        const auto colMajorT = nya::transpose(colMajor);
+        ASSERT_EQ(T.sizeX(), columns);
+        ASSERT_EQ(T.sizeY(), rows);
+        bool ok = true;
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < columns; ++j) {
+                ok &= T.at(j, i) == A.at(i, j) && colMajor.at(i, j) == A.at(i, j) && colMajorT.at(j, i) == A.at(i, j);
+            }
+        }
+        EXPECT_TRUE(ok) << rows << " x " << columns;
+        EXPECT_EQ(colMajor[1], A.at(1, 0));
+        EXPECT_EQ(back, A);
+    }
+
+    // padded source
+    auto P = nya::AlignedSurface<double>::padded(37, 29);
+    for (size_t i = 0; i < P.sizeX(); ++i) {
+        for (size_t j = 0; j < P.sizeY(); ++j) {
+            P.at(i, j) = 100.0 * i + j;
+        }
+    }
+    const auto Q = nya::convertLayout<false>(P);
+    EXPECT_EQ(Q.leadingDimension(), 37);
+    EXPECT_EQ(Q.at(36, 28), 3628.0);
+}
+
+TEST(LinearAlgebraTest, TransposeInPlace) {
+    // more than one tile: off-diagonal tiles are swapped in pairs
+    for (size_t n : { 1, 7, 64, 131, 256, 600, 777 }) {
+        auto A = randomMatrix(n, n, unsigned(n));
+        const auto original = A;
+        nya::transposeInPlace(nya::execution::par, A);
+        auto B = relayout<false>(original);
+        nya::transposeInPlace(B);
+        bool ok = true;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                ok &= A.at(i, j) == original.at(j, i) && B.at(i, j) == original.at(j, i);
+            }
+        }
+        EXPECT_TRUE(ok) << n;
+    }
+    auto rectangular = randomMatrix(3, 4, 1);
+    EXPECT_THROW(nya::transposeInPlace(rectangular), std::invalid_argument);
+}
+
+namespace {
+
+template <typename T>
+nya::Surface<T> dominantMatrix(size_t n, unsigned seed) {
+    const auto A = randomMatrix(n, n, seed);
+    nya::Surface<T> result (n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            result.at(i, j) = static_cast<T>(A.at(i, j)) + (i == j ? T(n) / 4 : T(0));
+        }
+    }
+    return result;
+}
+
+/**
+ * Max norm of error of solution of A x = b, where b = A * ones is computed exactly (integer-valued A).
+ */
+template <typename T, typename Solve>
+double solutionError(size_t n, Solve solve) {
+    auto A = dominantMatrix<T>(n, 5);
+    std::vector<T> b (n, T(0));
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            A.at(i, j) = static_cast<T>(static_cast<long long>(A.at(i, j) * 1024)) / 1024;
+            b[i] += A.at(i, j);
+        }
+    }
+    const std::vector<T> x = solve(A, b);
+    double error = 0;
+    for (const T xi : x) {
+        error = std::max(error, static_cast<double>(std::abs(xi - T(1))));
+    }
+    return error;
+}
+
+}
+
+TEST(LinearAlgebraTest, MixedPrecision) {
+    const size_t n = 150;
+    const auto single = solutionError<float>(n, [](const auto& A, const auto& b) {
+        return nya::LUFactorization<float> { A }.solve(b);
+    });
+    const auto refined = solutionError<double>(n, [](const auto& A, const auto& b) {
+        return nya::solveMixedPrecision(nya::execution::par, A, b);
+    });
+    EXPECT_GT(single, 1e-7);
+    EXPECT_LT(refined, 1e-15);
+
+    // padded storage: padding must not reach the factorization
+    const auto padded = solutionError<double>(n, [](const auto& A, const auto& b) {
+        auto P = nya::Surface<double>::padded(A.sizeX(), A.sizeY(), std::nan(""));
+        for (size_t i = 0; i < A.sizeX(); ++i) {
+            for (size_t j = 0; j < A.sizeY(); ++j) {
+                P.at(i, j) = A.at(i, j);
+            }
+        }
+        return nya::RefinedLUFactorization<double> { std::move(P) }.solve(b);
+    });
+    EXPECT_LT(padded, 1e-15);
+
+    const auto extended = solutionError<long double>(n, [](const auto& A, const auto& b) {
+        return nya::RefinedLUFactorization<long double> { A }.solve(b);
+    });
+    const auto extendedFromSingle = solutionError<long double>(n, [](const auto& A, const auto& b) {
+        return nya::solveMixedPrecision<float>(A, b);
+    });
+    const double extendedTolerance = std::max(1e-18, 4 * double(nya::PrecisionTraits<long double>::epsilon()));
+    EXPECT_LT(extended, extendedTolerance);
+    EXPECT_LT(extendedFromSingle, extendedTolerance);
+#ifdef NUMUTILS_HAS_FLOAT128
+    const auto quadruple = solutionError<__float128>(n, [](const auto& A, const auto& b) {
+        return nya::RefinedLUFactorization<__float128> { A }.solve(b);
+    });
+    EXPECT_LT(quadruple, 1e-30);
+#endif
+}
+
+TEST(LinearAlgebraTest, MixedPrecision_Fallback) {
+    // Hilbert matrix: cond ~ 1e13 is beyond what refinement from float can fix
+    const size_t n = 10;
+    nya::Surface<double> H (n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            H.at(i, j) = 1.0 / double(i + j + 1);
+        }
+    }
+    const std::vector<double> b (n, 1.0);
+    const auto x = nya::solveMixedPrecision(H, b);
+    EXPECT_EQ(x, nya::LUFactorization<double> { H }.solve(b));
+    EXPECT_EQ(x, nya::solveMixedPrecision(nya::convertLayout<false>(H), b));
+}
+
+TEST(LinearAlgebraTest, MixedPrecision_Overflow) {
+    // A x overflows in float: refinement sees NaN residuals and must fall back to double
+    nya::Surface<double> A (2, 2);
+    A.at(0, 0) = 1e200;
+    A.at(0, 1) = 1e200;
+    A.at(1, 0) = 1;
+    A.at(1, 1) = 2;
+    const std::vector<double> b { 2e200, 3 };
+    const auto x = nya::solveMixedPrecision(A, b);
+    EXPECT_EQ(x, nya::LUFactorization<double> { A }.solve(b));
+    EXPECT_NEAR(x[0], 1, 1e-15);
+    EXPECT_NEAR(x[1], 1, 1e-15);
+}
+
+TEST(LinearAlgebraTest, MixedPrecision_SingularInReduced) {
+    // 1 + 1e-10 rounds to 1 in float
+    nya::Surface<double> A (2, 2);
+    A.at(0, 0) = 1;
+    A.at(0, 1) = 1;
+    A.at(1, 0) = 1;
+    A.at(1, 1) = 1 + 1e-10;
+    const std::vector<double> b { 2, 2 + 1e-10 };
+    const nya::RefinedLUFactorization<double> lu { A };
+    EXPECT_EQ(lu.reduced(), nullptr);
+    const auto x = lu.solve(b);
+    EXPECT_EQ(x, nya::LUFactorization<double> { A }.solve(b));
+    EXPECT_NEAR(x[0], 1, 1e-5);
+    EXPECT_NEAR(x[1], 1, 1e-5);
+
+    nya::Surface<double> S (2, 2, 1.0);
+    EXPECT_THROW(nya::solveMixedPrecision(S, b), std::runtime_error);
+}
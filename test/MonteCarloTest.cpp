@@ -0,0 +1,104 @@
+#include "TestUtils.hpp"
+
+#include <NumericalUtils.hpp>
+
+TEST(MonteCarloTest, Philox_KnownAnswer) {
+    // test vectors of Random123
+    EXPECT_EQ(nya::Philox4x32::generate({ 0, 0, 0, 0 }, { 0, 0 }),
+              (nya::Philox4x32::Counter { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 }));
+    EXPECT_EQ(nya::Philox4x32::generate({ 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }, { 0xffffffff, 0xffffffff }),
+              (nya::Philox4x32::Counter { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd }));
+}
+
+TEST(MonteCarloTest, Sobol_Stratification) {
+    // in every single dimension, each of 16 intervals of length 2^-4 holds exactly one of the first 16 points
+    const nya::Sobol<double> sobol { 16, 0, 0 };
+    std::vector<double> points (16 * 16);
+    for (size_t i = 0; i < 16; ++i) {
+        sobol.point(i, points.data() + 16 * i);
+    }
+    for (size_t d = 0; d < 16; ++d) {
+        std::vector<int> counts (16);
+        for (size_t i = 0; i < 16; ++i) {
+            ++counts[static_cast<size_t>(points[16 * i + d] * 16)];
+        }
+        for (auto count : counts) {
+            EXPECT_EQ(count, 1);
+        }
+    }
+    EXPECT_THROW((nya::Sobol<double> { 17, 0, 0 }), std::invalid_argument);
+
+    // index is 32-bit, so monteCarloIntegral clamps maxSamples to it
+    EXPECT_EQ(nya::Sobol<double>::maxPoints, uint64_t(1) << 32);
+}
+
+TEST(MonteCarloTest, Integral) {
+    // integral of exp(x + y + z) over [0, 1]^3
+    const auto f = [](auto x, auto y, auto z) { using std::exp; return exp(x + y + z); };
+    const double exact = std::pow(std::exp(1.0) - 1.0, 3);
+    const std::vector<std::pair<double, double>> box { { 0.0, 1.0 }, { 0.0, 1.0 }, { 0.0, 1.0 } };
+    nya::MonteCarloOptions<double> options;
+
+    const auto mc = nya::monteCarloIntegral<nya::PseudoRandom>(f, options)(box, nya::dVar, nya::dVar, nya::dVar);
+    EXPECT_TRUE(mc.converged);
+    EXPECT_LT(mc.error, 1e-3 * exact);
+    EXPECT_NEAR(mc.value, exact, 5 * mc.error);
+
+    // quasi-random points reach the same tolerance with far fewer samples
+    for (const auto& qmc : { nya::monteCarloIntegral<nya::Sobol>(f, options)(box, nya::dVar, nya::dVar, nya::dVar),
+                             nya::monteCarloIntegral<nya::Halton>(f, options)(box, nya::dVar, nya::dVar, nya::dVar) }) {
+        EXPECT_TRUE(qmc.converged);
+        EXPECT_NEAR(qmc.value, exact, 5 * qmc.error);
+        EXPECT_LT(qmc.samples * 10, mc.samples);
+    }
+
+    // sample limit
+    options.maxSamples = 1 << 12;
+    const auto limited = nya::monteCarloIntegral<nya::PseudoRandom>(f, options)(box, nya::dVar, nya::dVar, nya::dVar);
+    EXPECT_FALSE(limited.converged);
+    EXPECT_EQ(limited.samples, 1 << 12);
+}
+
+TEST(MonteCarloTest, BoundArguments) {
+    // integral of a * x * y over [0, 2] x [0, 1] with a = 3 bound in the middle
+    const auto f = [](double x, double a, double y) { return a * x * y; };
+    const std::vector<std::pair<double, double>> box { { 0.0, 2.0 }, { 0.0, 1.0 } };
+    nya::MonteCarloOptions<double> options;
+    options.relTol = 1e-5;
+    const double value = nya::monteCarloIntegral(f, options)(box, nya::dVar, 3.0, nya::dVar);
+    EXPECT_NEAR(value, 3.0, 1e-4);
+    EXPECT_THROW(nya::monteCarloIntegral(f)(box, nya::dVar, 3.0, 1.0), std::invalid_argument);
+
+    // single argument function needs no placeholders
+    EXPECT_NEAR(nya::monteCarloIntegral([](double x) { return x * x; }, options)({ { 0.0, 3.0 } }).value, 9.0, 1e-3);
+}
+
+TEST(MonteCarloTest, Reproducible) {
+    const auto f = [](double x, double y) { return std::sin(x * y); };
+    const auto batchedF = nya::batched<4>([](auto x, auto y) { using std::sin; return sin(x * y); });
+    const std::vector<std::pair<double, double>> box { { 0.0, 1.0 }, { 0.0, 2.0 } };
+    nya::MonteCarloOptions<double> options;
+    options.relTol = 1e-3;
+    options.seed = 42;
+
+    // results do not depend on policy, and batched function takes the same samples
+    const auto seq = nya::monteCarloIntegral<nya::PseudoRandom>(f, options)(box, nya::dVar, nya::dVar);
+    const auto par = nya::monteCarloIntegral<nya::PseudoRandom>(nya::execution::par, f, options)
+        (box, nya::dVar, nya::dVar);
+    const auto batch = nya::monteCarloIntegral<nya::PseudoRandom>(nya::execution::par, batchedF, options)
+        (box, nya::dVar, nya::dVar);
+    EXPECT_EQ(seq.value, par.value);
+    EXPECT_EQ(seq.error, par.error);
+    EXPECT_EQ(seq.samples, par.samples);
+    EXPECT_NEAR(seq.value, batch.value, 1e-12);
+
+    const auto qmcSeq = nya::monteCarloIntegral(f, options)(box, nya::dVar, nya::dVar);
+    const auto qmcPar = nya::monteCarloIntegral(nya::execution::par, f, options)(box, nya::dVar, nya::dVar);
+    EXPECT_EQ(qmcSeq.value, qmcPar.value);
+
+    // different seed gives a different (but consistent) estimate
+    options.seed = 43;
+    const auto other = nya::monteCarloIntegral<nya::PseudoRandom>(f, options)(box, nya::dVar, nya::dVar);
+    EXPECT_NE(seq.value, other.value);
+    EXPECT_NEAR(seq.value, other.value, 5 * (seq.error + other.error));
+}
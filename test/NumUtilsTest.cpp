@@ -55,8 +55,61 @@ TEST(NumUtilsTest, FunctionDerivative) {
 
     // first
     EXPECT_NEAR(nya::D<nya::LFD1>(f)(x), (2.0*x - 1.0), nya::PrecisionTraits<double>::derivativeError());
-    // second // todo too big error, fix
-//    EXPECT_NEAR(nya::D<nya::>(f)(x), 2.0, PrecisionTraits<double>::derivativeError() * 100);
+    // second
+    EXPECT_NEAR((nya::D<nya::CFD2, 2>(f)(x)), 2.0, nya::PrecisionTraits<double>::derivativeError());
+}
+
+TEST(NumUtilsTest, FunctionDerivative_Stencils) {
+    // weights generated at compile time match the textbook ones
+    constexpr auto lfd2 = nya::LFD2<double>::weights<1>;
+    static_assert(lfd2[0] == 0.5 && lfd2[1] == -2.0 && lfd2[2] == 1.5);
+    constexpr auto rfd1 = nya::RFD1<double>::weights<1>;
+    static_assert(rfd1[0] == -1.0 && rfd1[1] == 1.0);
+    constexpr auto cfd2 = nya::CFD2<double>::weights<2>;
+    static_assert(cfd2[0] == 1.0 && cfd2[1] == -2.0 && cfd2[2] == 1.0);
+    EXPECT_EQ(nya::CFD4<double>::first<1>, -2);
+    const auto& cfd4 = nya::CFD4<double>::weights<1>;
+    const double expected[] = { 1.0 / 12, -2.0 / 3, 0.0, 2.0 / 3, -1.0 / 12 };
+    for (size_t k = 0; k < cfd4.size(); ++k) {
+        EXPECT_NEAR(cfd4[k], expected[k], 1e-15);
+    }
+
+    // error decreases with order of accuracy
+    const auto f = [](auto x) { using std::sin; return sin(x); };
+    const double x = 0.7;
+    const auto error = [&](auto derivative, double exact) { return std::abs(derivative(x) - exact); };
+    EXPECT_LT(error(nya::D<nya::LFD1>(f), std::cos(x)), 1e-7);
+    EXPECT_LT(error(nya::D<nya::RFD1>(f), std::cos(x)), 1e-7);
+    EXPECT_LT(error(nya::D<nya::LFD2>(f), std::cos(x)), 1e-9);
+    EXPECT_LT(error(nya::D<nya::RFD2>(f), std::cos(x)), 1e-9);
+    EXPECT_LT(error(nya::D<nya::CFD2>(f), std::cos(x)), 1e-9);
+    EXPECT_LT(error(nya::D<nya::CFD4>(f), std::cos(x)), 1e-11);
+    EXPECT_LT(error(nya::D<nya::CFD4, 2>(f), -std::sin(x)), 1e-8);
+    EXPECT_LT(error(nya::D<nya::CFD4, 3>(f), -std::cos(x)), 1e-5);
+}
+
+TEST(NumUtilsTest, Differentiate_Samples) {
+    const auto range = nya::Range<double> { 0.0, 1001, 1e-3 };
+    size_t evaluations = 0;
+    const auto f = [&evaluations](double x) { ++evaluations; return std::exp(x); };
+
+    // one evaluation per point, accuracy is kept near the ends
+    const auto first = nya::differentiate<nya::CFD4>(f, range);
+    EXPECT_EQ(evaluations, range.count());
+    const auto second = nya::differentiate<nya::CFD4, 2>(nya::execution::par, f, range);
+    ASSERT_EQ(first.size(), range.count());
+    size_t i = 0;
+    for (auto x : range) {
+        EXPECT_NEAR(first[i], std::exp(x), 1e-11);
+        EXPECT_NEAR(second[i], std::exp(x), 1e-7);
+        ++i;
+    }
+
+    // same as stencil applied by D to the same step
+    const std::vector<double> samples { 0.0, 1.0, 4.0, 9.0, 16.0 };
+    EXPECT_EQ(nya::differentiate<nya::LFD1>(samples, 1.0), (std::vector<double> { 1.0, 1.0, 3.0, 5.0, 7.0 }));
+    EXPECT_EQ(nya::differentiate<nya::CFD2>(samples, 1.0), (std::vector<double> { 0.0, 2.0, 4.0, 6.0, 8.0 }));
+    EXPECT_THROW(nya::differentiate<nya::CFD4>(std::vector<double>(3), 1.0), std::invalid_argument);
 }
 
 TEST(NumUtilsTest, FunctionIntegral_Euler) {
@@ -73,6 +126,58 @@ TEST(NumUtilsTest, FunctionIntegral_RK4) {
     EXPECT_NEAR(nya::integral<nya::RK4>(f)(xRange), 1.0 / 3.0 - 1.0 / 2.0, 1e-10); // todo move absError into Stepper classes
 }
 
+// error of integral of exp(x) over [0, 1], split into given number of cells
+template <template <typename> typename Stepper>
+double expIntegralError(size_t cells) {
+    auto f = [](auto x) { using std::exp; return exp(x); };
+    return std::abs(nya::integral<Stepper>(f)(nya::Range { 0.0, cells, 1.0 / cells }) - (std::exp(1) - 1));
+}
+
+TEST(NumUtilsTest, FunctionIntegral_CompositeRules) {
+    // exact for polynomials of degree 1, 3, 5 and 2n - 1 respectively
+    auto xRange = nya::discreteRange<1>(0.0, 1.0);
+    EXPECT_NEAR(nya::integral<nya::Trapezoid>([](auto x) { return 3 * x - 1; })(xRange), 0.5, 1e-14);
+    EXPECT_NEAR(nya::integral<nya::Simpson>([](auto x) { return x * x * x; })(xRange), 0.25, 1e-14);
+    EXPECT_NEAR(nya::integral<nya::Boole>([](auto x) { return x * x * x * x * x; })(xRange), 1.0 / 6.0, 1e-14);
+    EXPECT_NEAR(nya::integral<nya::GL3>([](auto x) { return x * x * x * x * x; })(xRange), 1.0 / 6.0, 1e-14);
+
+    // doubling number of cells divides error by 2^order
+    EXPECT_NEAR(std::log2(expIntegralError<nya::Trapezoid>(8) / expIntegralError<nya::Trapezoid>(16)), 2.0, 0.05);
+    EXPECT_NEAR(std::log2(expIntegralError<nya::Simpson>(8) / expIntegralError<nya::Simpson>(16)), 4.0, 0.05);
+    EXPECT_NEAR(std::log2(expIntegralError<nya::Boole>(4) / expIntegralError<nya::Boole>(8)), 6.0, 0.1);
+    EXPECT_NEAR(std::log2(expIntegralError<nya::GL2>(8) / expIntegralError<nya::GL2>(16)), 4.0, 0.05);
+
+    // 10^3 points are enough for what 10^6 points of Euler give
+    auto g = [](auto x) { using std::sin; return x * sin(x); };
+    const double exact = std::sin(1) - std::cos(1);
+    EXPECT_LT(std::abs(nya::integral<nya::Simpson>(g)(nya::discreteRange<3>(0.0, 1.0)) - exact),
+              std::abs(nya::integral<nya::Euler>(g)(nya::discreteRange<6>(0.0, 1.0)) - exact));
+}
+
+TEST(NumUtilsTest, FunctionIntegral_SharedEndpoints) {
+    size_t evaluations = 0;
+    auto f = [&evaluations](double x) { ++evaluations; return x * x; };
+    auto xRange = nya::discreteRange<3>(0.0, 1.0);
+
+    // interior endpoints are evaluated once (plus both ends of the range for the correction)
+    EXPECT_NEAR(nya::integral<nya::Simpson>(f)(xRange), 1.0 / 3.0, 1e-14);
+    EXPECT_EQ(evaluations, 2 * xRange.count() + 2);
+    evaluations = 0;
+    EXPECT_NEAR(nya::integral<nya::Boole>(f)(xRange), 1.0 / 3.0, 1e-14);
+    EXPECT_EQ(evaluations, 4 * xRange.count() + 2);
+
+    // same nodes are merged when tabulated
+    EXPECT_EQ(nya::QuadratureRule<double>::fromRange<nya::Simpson>(xRange).size(), 2 * xRange.count() + 1);
+
+    // chunked, parallel and batched paths give the same sums
+    auto g = [](auto x) { using std::sin; return x * sin(x); };
+    auto largeRange = nya::Range { 0.0, 100'003, 1.0 / 100'003 };
+    const double sequential = nya::integral<nya::Boole>(g)(largeRange);
+    EXPECT_NEAR(sequential, std::sin(1) - std::cos(1), 1e-14);
+    EXPECT_NEAR(nya::integral<nya::Boole>(nya::execution::par, g)(largeRange), sequential, 1e-14);
+    EXPECT_NEAR(nya::integral<nya::Boole>(nya::batched<4>(g))(largeRange), sequential, 1e-14);
+}
+
 TEST(NumUtilsTest, FunctionIntegral_Multi) {
     auto xRange = nya::discreteRange<6>(0.0, 1.0);
     auto f = [](auto x, auto y) { return y*std::sin(x) + x*std::cos(y); };
@@ -87,6 +192,317 @@ TEST(NumUtilsTest, FunctionIntegral_Multi) {
     EXPECT_NEAR(f2ByY(xRange, 1, 0.0), std::sin(1)/2 + std::sin(1), 1e-6); // todo low precision
 }
 
+TEST(NumUtilsTest, FunctionIntegral_Parallel) {
+    auto xRange = nya::discreteRange<6>(0.0, 1.0);
+    auto f = [](auto x) { return x * x - x; };
+
+    const auto parallel = nya::integral<nya::Euler>(nya::execution::par, f)(xRange);
+    EXPECT_NEAR(parallel, 1.0 / 3.0 - 1.0 / 2.0, 1e-8);
+    // fixed chunking => reproducible regardless of scheduling
+    EXPECT_EQ(parallel, nya::integral<nya::Euler>(nya::execution::par, f)(xRange));
+    EXPECT_EQ(parallel, nya::integral<nya::Euler>(nya::execution::par_unseq, f)(xRange));
+    // sequenced policy is the same as default overload
+    EXPECT_EQ(nya::integral<nya::Euler>(nya::execution::seq, f)(xRange), nya::integral<nya::Euler>(f)(xRange));
+
+    // multiple variables
+    auto g = [](auto x, auto y) { return y*std::sin(x) + x*std::cos(y); };
+    auto gByY = nya::integral<nya::RK4, 1>(nya::execution::par, g);
+    EXPECT_NEAR(gByY(xRange, 1, 0.0), std::sin(1)/2 + std::sin(1), 1e-6);
+}
+
+TEST(NumUtilsTest, FunctionIntegral_Batched) {
+    auto xRange = nya::Range { 0.0, 1'000'003, 1.0 / 1'000'003 }; // not a multiple of batch size
+    auto f = [](auto x) { using std::sin; return x * sin(x); };
+
+    const auto scalar = nya::integral<nya::Euler>(f)(xRange);
+    EXPECT_NEAR(nya::integral<nya::Euler>(nya::batched<4>(f))(xRange), scalar, 1e-12);
+    EXPECT_NEAR(nya::integral<nya::RK4>(nya::batched<8>(f))(xRange), nya::integral<nya::RK4>(f)(xRange), 1e-12);
+    EXPECT_NEAR(nya::integral<nya::Euler>(nya::execution::par, nya::batched<4>(f))(xRange), scalar, 1e-12);
+
+    // bound variables
+    auto g = [](auto x, auto y) { using std::exp; return exp(x)*y; };
+    auto gByY = nya::integral<nya::Euler, 1>(nya::batched(g));
+    EXPECT_NEAR(gByY(nya::discreteRange(0.0, 1.0), 1.0, nya::dVar), std::exp(1) * 0.5, 1e-5);
+}
+
+TEST(NumUtilsTest, FunctionIntegral_Sweep) {
+    auto g = [](auto x, auto y) { using std::exp; return exp(x) * y + x; };
+    std::vector<double> xs (1003); // not a multiple of batch size
+    for (size_t i = 0; i < xs.size(); ++i) {
+        xs[i] = -1.0 + 0.002 * i;
+    }
+    auto yRange = nya::discreteRange<3>(0.0, 1.0);
+
+    // same as integrating for every value separately
+    const auto byY = nya::integral<nya::Simpson, 1>(g);
+    const auto sweep = nya::integralSweep<nya::Simpson, 1>(g)(yRange, xs, nya::dVar, nya::dVar);
+    ASSERT_EQ(sweep.size(), xs.size());
+    for (size_t i = 0; i < xs.size(); ++i) {
+        EXPECT_NEAR(sweep[i], byY(yRange, xs[i], nya::dVar), 1e-13);
+        EXPECT_NEAR(sweep[i], std::exp(xs[i]) / 2 + xs[i], 1e-13);
+    }
+
+    // batches of parameter values and parallel chunks
+    const auto batchSweep = nya::integralSweep<nya::Simpson, 1>(nya::batched<4>(g))(yRange, xs, nya::dVar, nya::dVar);
+    const auto parallelSweep = nya::integralSweep<nya::Simpson, 1>(nya::execution::par, nya::batched<4>(g))(
+        yRange, xs, nya::dVar, nya::dVar);
+    EXPECT_EQ(batchSweep, parallelSweep);
+    for (size_t i = 0; i < xs.size(); ++i) {
+        EXPECT_NEAR(batchSweep[i], sweep[i], 1e-13);
+    }
+
+    // parameter before integration variable, and quadrature rule as domain
+    const auto rule = nya::QuadratureRule<double>::gaussLegendre(5, 0.0, 1.0);
+    const std::vector<double> ys { 0.0, 2.0 };
+    const auto byX = nya::integralSweep<nya::Euler, 0, 1>(g)(rule, ys, nya::dVar, nya::dVar);
+    EXPECT_NEAR(byX[0], 0.5, 1e-12);
+    EXPECT_NEAR(byX[1], 2 * (std::exp(1) - 1) + 0.5, 1e-10);
+}
+
+TEST(NumUtilsTest, MultiIntegral_TensorProduct) {
+    auto f = [](auto x, auto y, auto z) { using std::exp; return x * y * y + exp(z); };
+    const auto domains = std::make_tuple(nya::discreteRange<2>(0.0, 1.0), nya::discreteRange<2>(0.0, 1.0),
+                                         nya::discreteRange<2>(0.0, 1.0));
+    const double expected = 0.5 / 3.0 + (std::exp(1) - 1);
+    const double value = nya::multiIntegral<nya::Simpson>(f)(domains);
+    EXPECT_NEAR(value, expected, 1e-9);
+
+    // same as nested integrals
+    auto byZ = nya::integral<nya::Simpson, 2>(f);
+    auto byYZ = nya::integral<nya::Simpson, 1>([&](double x, double y) {
+        return byZ(std::get<2>(domains), x, y, nya::dVar);
+    });
+    auto byXYZ = nya::integral<nya::Simpson>([&](double x) { return byYZ(std::get<1>(domains), x, nya::dVar); });
+    EXPECT_NEAR(byXYZ(std::get<0>(domains)), value, 1e-13);
+
+    // batched, parallel and quadrature rules as axes
+    EXPECT_NEAR(nya::multiIntegral<nya::Simpson>(nya::batched<4>(f))(domains), value, 1e-13);
+    EXPECT_NEAR(nya::multiIntegral<nya::Simpson>(nya::execution::par, f)(domains), value, 1e-13);
+    const auto rule = nya::QuadratureRule<double>::gaussLegendre(4, 0.0, 1.0);
+    EXPECT_NEAR(nya::multiIntegral<nya::Simpson>(f)(std::make_tuple(rule, rule, std::get<2>(domains))), expected, 1e-9);
+}
+
+TEST(NumUtilsTest, MultiIntegral_SparseGrid) {
+    // 1D Clenshaw-Curtis rules are exact for polynomials of degree n - 1 (n if n is odd)
+    const auto cc = nya::QuadratureRule<double>::clenshawCurtis(5, 0.0, 2.0);
+    EXPECT_NEAR(cc.integrate([](double x) { return x * x * x * x * x; }), 64.0 / 6.0, 1e-12);
+
+    // exact for polynomials of total degree up to 2*level + 1
+    const auto grid = nya::CubatureRule<double, 4>::smolyak(2, { 0.0, 0.0, 0.0, 0.0 }, { 1.0, 1.0, 1.0, 2.0 });
+    auto polynomial = [](auto x, auto y, auto z, auto w) { return x * x * y * z * w + 3 * x * y + w * w * w; };
+    const double exact = 1.0 / 6.0 + 1.5 + 4.0;
+    EXPECT_NEAR(nya::multiIntegral<nya::Simpson>(polynomial)(grid), exact, 1e-12);
+    EXPECT_LT(grid.size(), 5u * 5u * 5u * 5u); // full tensor product of the finest 1D rules
+
+    // only multi-indices near the level are visited, so high dimensions are cheap (3^20 of all of them here)
+    std::array<double, 20> zeros, ones;
+    zeros.fill(0.0);
+    ones.fill(1.0);
+    const auto wide = nya::CubatureRule<double, 20>::smolyak(2, zeros, ones);
+    double moment = 0;
+    for (size_t i = 0; i < wide.size(); ++i) {
+        const double* x = &wide.nodes()[i * 20];
+        moment += wide.weights()[i] * (x[0] * x[0] * x[19] + x[7] * x[7] * x[7] * x[7] * x[7]);
+    }
+    EXPECT_NEAR(moment, 1.0 / 6.0 + 1.0 / 6.0, 1e-13);
+
+    // smooth function in 6 dimensions
+    std::array<double, 6> from, to;
+    from.fill(0.0);
+    to.fill(1.0);
+    auto gaussian = [](auto a, auto b, auto c, auto d, auto e, auto f) {
+        using std::exp;
+        return exp(-(a * a + b * b + c * c + d * d + e * e + f * f));
+    };
+    const double exact1D = 0.74682413281242702540; // integral of exp(-x^2) over [0, 1]
+    const auto fine = nya::CubatureRule<double, 6>::smolyak(5, from, to);
+    const double value = nya::multiIntegral<nya::Simpson>(gaussian)(fine);
+    EXPECT_NEAR(value, std::pow(exact1D, 6), 1e-7);
+    EXPECT_NEAR(nya::multiIntegral<nya::Simpson>(nya::execution::par, nya::batched<4>(gaussian))(fine), value, 1e-13);
+}
+
+TEST(NumUtilsTest, Accumulators_Cancellation) {
+    const double terms[] = { 1.0, 1e100, 1.0, -1e100 };
+    nya::NaiveSum<double> naive;
+    nya::KahanSum<double> kahan;
+    nya::NeumaierSum<double> neumaier;
+    for (auto term : terms) {
+        naive.add(term);
+        kahan.add(term);
+        neumaier.add(term);
+    }
+    EXPECT_DOUBLE_EQ(naive.result(), 0.0);
+    EXPECT_DOUBLE_EQ(kahan.result(), 0.0);
+    EXPECT_DOUBLE_EQ(neumaier.result(), 2.0);
+
+    nya::PairwiseSum<double> pairwise;
+    for (int i = 1; i <= 100'000; ++i) {
+        pairwise.add(i);
+    }
+    EXPECT_DOUBLE_EQ(pairwise.result(), 100'000.0 * 100'001.0 / 2);
+}
+
+TEST(NumUtilsTest, FunctionIntegral_Accumulators) {
+    // 10^7 equal terms in single precision: naive sum loses several digits
+    auto xRange = nya::Range<float> { 0.0f, 10'000'000, 1e-7f };
+    auto f = [](auto) { return 1.0f; };
+    const float exact = 10'000'000 * 1e-7f;
+
+    EXPECT_GT(std::abs(nya::integral<nya::Euler, 0, float, nya::NaiveSum>(f)(xRange) - exact), 1e-3);
+    EXPECT_NEAR((nya::integral<nya::Euler, 0, float, nya::KahanSum>(f)(xRange)), exact, 1e-6);
+    EXPECT_NEAR((nya::integral<nya::Euler, 0, float, nya::NeumaierSum>(f)(xRange)), exact, 1e-5);
+    EXPECT_NEAR((nya::integral<nya::Euler, 0, float, nya::PairwiseSum>(f)(xRange)), exact, 1e-6);
+
+    // batched and parallel paths
+    auto fb = nya::batched<8>(f);
+    EXPECT_NEAR((nya::integral<nya::Euler, 0, float, nya::NeumaierSum>(fb)(xRange)), exact, 1e-5);
+    EXPECT_NEAR((nya::integral<nya::Euler, 0, float, nya::KahanSum>(nya::execution::par, fb)(xRange)), exact, 1e-6);
+}
+
+TEST(NumUtilsTest, FunctionAdaptiveIntegral) {
+    // smooth function: single application of the rule is enough
+    auto smooth = nya::adaptiveIntegral(
+        [](auto x) { return std::exp(x) * std::cos(x); }
+    )(0.0, 1.0);
+    EXPECT_TRUE(smooth.converged);
+    EXPECT_NEAR(smooth.value, (std::exp(1) * (std::cos(1) + std::sin(1)) - 1) / 2, 1e-14);
+    EXPECT_EQ(smooth.evaluations, 21);
+
+    // infinite derivative at 0: subdivision near 0 is required
+    auto singular = nya::adaptiveIntegral([](auto x) { return std::sqrt(x); }, 1e-12, 1e-12)(0.0, 1.0);
+    EXPECT_TRUE(singular.converged);
+    EXPECT_GT(singular.intervals, 1);
+    EXPECT_NEAR(singular.value, 2.0 / 3.0, 1e-12);
+    EXPECT_LE(singular.error, 1e-12);
+
+    // bound variables
+    auto f = [](auto x, auto y) { return y*std::sin(x) + x*std::cos(y); };
+    auto fByY = nya::adaptiveIntegral<nya::GK21, 1>(f);
+    EXPECT_NEAR(fByY(0.0, 1.0, 1.0, nya::dVar), std::sin(1)/2 + std::sin(1), 1e-12);
+
+    // does not loop forever on non-integrable function
+    auto divergent = nya::adaptiveIntegral([](auto x) { return 1 / x; }, 1e-12, 1e-12, 50)(0.0, 1.0);
+    EXPECT_FALSE(divergent.converged);
+    EXPECT_EQ(divergent.intervals, 50);
+}
+
+TEST(NumUtilsTest, FunctionIntegral_GK21) {
+    auto f = [](auto x) { return x * std::exp(x); };
+    EXPECT_NEAR(nya::integral<nya::GK21>(f)(nya::discreteRange<1>(0.0, 1.0)), 1.0, 1e-14);
+}
+
+TEST(NumUtilsTest, QuadratureRule) {
+    auto f = [](auto x) { using std::exp; return x * exp(x); };
+
+    // Gauss-Legendre: exact for polynomials of degree 2n - 1
+    auto gauss = nya::QuadratureRule<double>::gaussLegendre(5, -1.0, 2.0);
+    EXPECT_EQ(gauss.size(), 5);
+    EXPECT_NEAR(gauss.integrate([](auto x) { return std::pow(x, 9); }), (std::pow(2, 10) - 1) / 10, 1e-12);
+    EXPECT_NEAR(nya::QuadratureRule<double>::gaussLegendre(20, 0.0, 1.0).integrate(f), 1.0, 1e-15);
+
+    // tabulated range gives the same integral as stepping through it
+    auto range = nya::discreteRange<3>(0.0, 1.0);
+    auto euler = nya::QuadratureRule<double>::fromRange<nya::Euler>(range);
+    EXPECT_EQ(euler.size(), range.count());
+    EXPECT_NEAR(nya::integral<nya::Euler>(f)(euler), nya::integral<nya::Euler>(f)(range), 1e-14);
+    EXPECT_NEAR(nya::integral<nya::Euler>(nya::execution::par, nya::batched(f))(euler),
+                nya::integral<nya::Euler>(f)(range), 1e-14);
+    auto gk = nya::QuadratureRule<double>::fromRange<nya::GK21>(nya::discreteRange<1>(0.0, 1.0));
+    EXPECT_EQ(gk.size(), 210);
+    EXPECT_NEAR(nya::innerProduct<nya::Euler>(f, [](auto) { return 2.0; })(gk), 2.0, 1e-14);
+
+    // cache returns the same rule for the same key
+    auto& cache = nya::QuadratureRuleCache<double>::instance();
+    auto rule = cache.fromRange<nya::Euler>(range);
+    EXPECT_EQ(rule, cache.fromRange<nya::Euler>(range));
+    EXPECT_NE(rule, cache.fromRange<nya::GK21>(range));
+    EXPECT_EQ(cache.gaussLegendre(5, 0.0, 1.0), cache.gaussLegendre(5, 0.0, 1.0));
+    EXPECT_NE(cache.gaussLegendre(5, 0.0, 1.0), cache.gaussLegendre(6, 0.0, 1.0));
+}
+
+TEST(NumUtilsTest, Galerkin) {
+    // y' - y = 0, y(0) = 1  =>  y = exp(x)
+    auto L = [](auto f) { return nya::sum(nya::D<nya::LFD1>(f), nya::negate(f)); };
+    auto range = nya::discreteRange<4>(0.0, 1.0);
+
+    auto& cache = nya::QuadratureRuleCache<double>::instance();
+    cache.clear();
+    auto y = nya::galerkin<nya::Euler>(L, nya::polynomials(5))(range);
+    EXPECT_EQ(cache.size(), 0); // ranges are tabulated into temporary rules
+    EXPECT_NEAR(y(0.0), 1.0, 1e-12);
+    EXPECT_NEAR(y(0.5), std::exp(0.5), 1e-4);
+    EXPECT_NEAR(y(1.0), std::exp(1.0), 1e-4);
+
+    // precomputed rule can be passed directly
+    auto gauss = nya::QuadratureRule<double>::gaussLegendre(20, 0.0, 1.0);
+    auto yGauss = nya::galerkin<nya::Euler>(L, nya::polynomials(5))(gauss);
+    EXPECT_NEAR(yGauss(1.0), std::exp(1.0), 1e-4);
+}
+
+/**
+ * Euler stepper without cellNodes(): galerkin has to integrate every entry separately.
+ */
+template <typename T>
+struct EulerWithoutNodes {
+    template <typename F, typename X>
+    auto operator()(const F& f, T h, X x) const {
+        return h * f(x);
+    }
+};
+
+static_assert(!nya::hasFixedNodes<EulerWithoutNodes, double>);
+
+TEST(NumUtilsTest, Galerkin_TabulatedAssembly) {
+    auto L = [](auto f) { return nya::sum(nya::D<nya::LFD1>(f), nya::negate(f)); };
+    auto trials = nya::polynomials(6);
+    auto rule = nya::QuadratureRule<double>::fromRange<nya::Euler>(nya::discreteRange<4>(0.0, 1.0));
+
+    // tabulated assembly computes the same inner products
+    auto perEntry = nya::detail::assembleGalerkin<nya::Euler, 0, double>(L, trials, rule);
+    auto tabulated = nya::detail::assembleGalerkinTabulated(L, trials, rule);
+    ASSERT_EQ(perEntry.size(), tabulated.size());
+    for (size_t i = 0; i < perEntry.size(); ++i) {
+        EXPECT_NEAR(perEntry[i], tabulated[i], 1e-12 * std::max(1.0, std::abs(perEntry[i])));
+    }
+
+    // per-entry assembly over a range with a stepper without fixed nodes gives the same system
+    auto range = nya::discreteRange<4>(0.0, 1.0);
+    auto perEntryRange = nya::detail::assembleGalerkin<EulerWithoutNodes, 0, double>(L, trials, range);
+    ASSERT_EQ(perEntryRange.size(), tabulated.size());
+    for (size_t i = 0; i < perEntryRange.size(); ++i) {
+        EXPECT_NEAR(perEntryRange[i], tabulated[i], 1e-12 * std::max(1.0, std::abs(tabulated[i])));
+    }
+    auto y = nya::galerkin<EulerWithoutNodes>(L, nya::polynomials(5))(range);
+    EXPECT_NEAR(y(1.0), nya::galerkin<nya::Euler>(L, nya::polynomials(5))(range)(1.0), 1e-12);
+}
+
+TEST(NumUtilsTest, Galerkin_Parallel) {
+    auto L = [](auto f) { return nya::sum(nya::D<nya::LFD1>(f), nya::negate(f)); };
+    auto trials = nya::polynomials(5);
+
+    // tabulated assembly
+    auto range = nya::discreteRange<5>(0.0, 1.0);
+    auto ySeq = nya::galerkin<nya::Euler>(L, trials)(range);
+    auto yPar = nya::galerkin<nya::Euler>(nya::execution::par, L, trials)(range);
+    EXPECT_NEAR(yPar(1.0), ySeq(1.0), 1e-12);
+    EXPECT_EQ(yPar(0.7), nya::galerkin<nya::Euler>(nya::execution::par, L, trials)(range)(0.7));
+
+    // per-entry assembly
+    auto perEntrySeq = nya::detail::assembleGalerkin<EulerWithoutNodes, 0, double>(L, trials, range);
+    auto perEntryPar = nya::detail::assembleGalerkin<EulerWithoutNodes, 0, double>(nya::execution::par, L, trials,
+                                                                                     range);
+    EXPECT_EQ(perEntryPar, perEntrySeq);
+    auto tabulated = nya::detail::assembleGalerkinTabulated(
+        nya::execution::par, L, trials, nya::QuadratureRule<double>::fromRange<nya::Euler>(range));
+    ASSERT_EQ(perEntryPar.size(), tabulated.size());
+    for (size_t i = 0; i < perEntryPar.size(); ++i) {
+        // nodes of the range and of the rule may differ in the last bit, which LFD1 amplifies
+        EXPECT_NEAR(perEntryPar[i], tabulated[i], 1e-10 * std::max(1.0, std::abs(tabulated[i])));
+    }
+    EXPECT_EQ(nya::galerkin<EulerWithoutNodes>(nya::execution::par, L, trials)(range)(1.0),
+              nya::galerkin<EulerWithoutNodes>(L, trials)(range)(1.0));
+}
+
 TEST(NumUtilsTest, FunctionInnerProduct) {
     auto xRange = nya::discreteRange<6>(0.0, 1.0);
     auto f = [](auto x) { return x; };
@@ -108,4 +524,4 @@ TEST(NumUtilsTest, FunctionPower) {
 
     auto fxZero = nya::power([](auto x) { return x + x*x; }, 0);
     EXPECT_DOUBLE_EQ(fxZero(5), 1);
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "TestUtils.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <Ode.hpp>
+
+// counts heap allocations, to check that ODE stepping does not allocate; replacing global operator new affects
+// the whole binary, so this test is built as a separate executable
+static std::atomic<size_t> allocations { 0 };
+
+void* operator new(size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc {};
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+TEST(OdeTest, NoAllocationsWhileStepping) {
+    const auto f = [](double t, const std::vector<double>& y, std::vector<double>& dydt) {
+        for (size_t i = 0; i < y.size(); ++i) {
+            dydt[i] = std::cos(t) - 0.1 * y[i];
+        }
+    };
+    auto adaptive = nya::ode::makeSolver<nya::ode::DormandPrince>(f, 0.0, std::vector<double>(100, 1.0));
+    auto fixed = nya::ode::makeSolver<nya::ode::RK4>(f, 0.0, std::vector<double>(100, 1.0), { 0, 0, 0.01 });
+    std::vector<double> y (100);
+
+    const size_t before = allocations;
+    for (int i = 0; i < 1000; ++i) {
+        adaptive.step();
+        fixed.step();
+    }
+    adaptive.interpolate(adaptive.time() - adaptive.stepSize() / 1000, y);
+    adaptive.advanceTo(adaptive.time() + 1.0);
+    EXPECT_EQ(allocations - before, 0);
+}
@@ -0,0 +1,68 @@
+#include "TestUtils.hpp"
+
+#include <array>
+#include <vector>
+
+#include <Ode.hpp>
+
+using Oscillator = std::array<double, 2>;
+
+// y'' = -y as a first order system; solution is (cos t, -sin t)
+const auto oscillator = [](double, const Oscillator& y, Oscillator& dydt) {
+    dydt[0] = y[1];
+    dydt[1] = -y[0];
+};
+
+TEST(OdeTest, RK4_Order) {
+    const auto f = [](double, double y) { return -y; };
+    const auto error = [&f](double h) {
+        return std::abs(nya::ode::solve<nya::ode::RK4>(f, 0.0, 1.0, 1.0, { 0, 0, h }) - std::exp(-1.0));
+    };
+    EXPECT_NEAR(std::log2(error(0.1) / error(0.05)), 4.0, 0.1);
+    EXPECT_LT(error(0.01), 1e-10);
+
+    // fixed step stepper needs step size
+    EXPECT_THROW(nya::ode::makeSolver<nya::ode::RK4>(f, 0.0, 1.0), std::invalid_argument);
+}
+
+TEST(OdeTest, DormandPrince_DenseOutput) {
+    nya::ode::Options<double> options;
+    options.absTol = options.relTol = 1e-10;
+    auto solver = nya::ode::makeSolver<nya::ode::DormandPrince>(oscillator, 0.0, Oscillator { 1.0, 0.0 }, options);
+
+    // dense output between steps is (almost) as accurate as the steps themselves
+    for (double t = 0.1; t <= 10.0; t += 0.1) {
+        const auto& y = solver.advanceTo(t);
+        EXPECT_NEAR(y[0], std::cos(t), 1e-8);
+        EXPECT_NEAR(y[1], -std::sin(t), 1e-8);
+    }
+    EXPECT_LT(solver.steps(), 400);
+    EXPECT_EQ(solver.evaluations(), 2 + 6 * (solver.steps() + solver.rejectedSteps()));
+    EXPECT_THROW(solver.advanceTo(0.0), std::invalid_argument);
+}
+
+TEST(OdeTest, RKF45_VectorState) {
+    // y_i' = -i*y_i
+    const auto f = [](double, const std::vector<double>& y, std::vector<double>& dydt) {
+        for (size_t i = 0; i < y.size(); ++i) {
+            dydt[i] = -static_cast<double>(i) * y[i];
+        }
+    };
+    nya::ode::Options<double> options;
+    options.absTol = options.relTol = 1e-9;
+    size_t observed = 0;
+    const auto y = nya::ode::solve<nya::ode::RKF45>(f, 0.0, std::vector<double>(5, 1.0), 2.0,
+                                                    [&observed](double, const auto&) { ++observed; }, options);
+    ASSERT_EQ(y.size(), 5);
+    for (size_t i = 0; i < y.size(); ++i) {
+        EXPECT_NEAR(y[i], std::exp(-2.0 * i), 1e-7);
+    }
+    EXPECT_GT(observed, 2);
+
+    // stiffer components force smaller steps
+    auto slow = nya::ode::makeSolver<nya::ode::RKF45>(f, 0.0, std::vector<double>(2, 1.0), options);
+    auto fast = nya::ode::makeSolver<nya::ode::RKF45>(f, 0.0, std::vector<double>(50, 1.0), options);
+    slow.advanceTo(1.0);
+    fast.advanceTo(1.0);
+    EXPECT_LT(slow.steps(), fast.steps());
+}
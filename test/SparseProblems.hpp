@@ -0,0 +1,36 @@
+#ifndef NUMUTILS_SPARSEPROBLEMS_HPP
+#define NUMUTILS_SPARSEPROBLEMS_HPP
+
+#include <vector>
+
+#include <Sparse.hpp>
+
+/**
+ * 5-point finite difference matrix of -u_xx - u_yy + c * (u_x + u_y) on grid x grid interior points of the unit
+ * square (symmetric positive definite for c = 0). Shared by sparse solver tests and benchmarks.
+ */
+inline nya::SparseMatrix<double> convectionDiffusion(size_t grid, double c) {
+    const double h = 1.0 / double(grid + 1);
+    std::vector<nya::Triplet<double>> triplets;
+    for (size_t i = 0; i < grid; ++i) {
+        for (size_t j = 0; j < grid; ++j) {
+            const size_t row = i * grid + j;
+            triplets.push_back({ row, row, 4.0 });
+            if (i > 0) {
+                triplets.push_back({ row, row - grid, -1.0 - c * h / 2 });
+            }
+            if (i + 1 < grid) {
+                triplets.push_back({ row, row + grid, -1.0 + c * h / 2 });
+            }
+            if (j > 0) {
+                triplets.push_back({ row, row - 1, -1.0 - c * h / 2 });
+            }
+            if (j + 1 < grid) {
+                triplets.push_back({ row, row + 1, -1.0 + c * h / 2 });
+            }
+        }
+    }
+    return nya::SparseMatrix<double>::fromTriplets(grid * grid, grid * grid, triplets);
+}
+
+#endif //NUMUTILS_SPARSEPROBLEMS_HPP
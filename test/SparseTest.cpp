@@ -0,0 +1,143 @@
+#include "TestUtils.hpp"
+#include "SparseProblems.hpp"
+
+#include <random>
+
+#include <NumericalUtils.hpp>
+
+namespace {
+
+std::vector<double> randomVector(size_t n, unsigned seed) {
+    std::mt19937 gen { seed };
+    std::uniform_real_distribution<double> dist { -1.0, 1.0 };
+    std::vector<double> x (n);
+    for (auto& v : x) {
+        v = dist(gen);
+    }
+    return x;
+}
+
+double residualNorm(const nya::SparseMatrix<double>& A, const std::vector<double>& x, const std::vector<double>& b) {
+    const auto Ax = nya::multiply(A, x);
+    double sum = 0;
+    for (size_t i = 0; i < b.size(); ++i) {
+        sum += (b[i] - Ax[i]) * (b[i] - Ax[i]);
+    }
+    return std::sqrt(sum);
+}
+
+}
+
+TEST(SparseTest, FromTriplets) {
+    const auto A = nya::SparseMatrix<double>::fromTriplets(3, 4, {
+        { 2, 3, 1.0 }, { 0, 1, 2.0 }, { 2, 0, 3.0 }, { 0, 1, 0.5 }, { 0, 0, -1.0 }, { 2, 3, 1.0 }
+    });
+    EXPECT_EQ(A.nonZeros(), 4);
+    EXPECT_EQ(A.rowOffsets(), (std::vector<size_t> { 0, 2, 2, 4 }));
+    EXPECT_EQ(A.columnIndices(), (std::vector<size_t> { 0, 1, 0, 3 }));
+    EXPECT_EQ(A.at(0, 1), 2.5);
+    EXPECT_EQ(A.at(2, 3), 2.0);
+    EXPECT_EQ(A.at(1, 1), 0.0);
+    EXPECT_EQ(A.diagonal(), (std::vector<double> { -1.0, 0.0, 0.0 }));
+    EXPECT_THROW(nya::SparseMatrix<double>::fromTriplets(3, 4, { { 3, 0, 1.0 } }), std::invalid_argument);
+    EXPECT_THROW(nya::SparseMatrix<double>(2, 2, { 0, 2, 2 }, { 1, 0 }, { 1.0, 1.0 }), std::invalid_argument);
+
+    nya::Surface<double, false> dense (3, 4);
+    dense.at(0, 0) = -1.0;
+    dense.at(0, 1) = 2.5;
+    dense.at(2, 0) = 3.0;
+    dense.at(2, 3) = 2.0;
+    dense.at(1, 2) = 1e-14;
+    const nya::SparseMatrix<double> B (dense, 1e-12);
+    EXPECT_EQ(B.columnIndices(), A.columnIndices());
+    EXPECT_EQ(B.values(), A.values());
+}
+
+TEST(SparseTest, Multiply) {
+    const auto A = convectionDiffusion(150, 10.0);
+    const auto x = randomVector(A.columns(), 1);
+    const auto y = nya::multiply(nya::execution::par, A, x);
+    for (size_t row : { size_t(0), size_t(151), A.rows() - 1 }) {
+        double expected = 0;
+        for (size_t column = 0; column < A.columns(); ++column) {
+            expected += A.at(row, column) * x[column];
+        }
+        EXPECT_NEAR(y[row], expected, 1e-14);
+    }
+    EXPECT_EQ(y, nya::multiply(A, x));
+}
+
+TEST(SparseTest, ConjugateGradient) {
+    const auto A = convectionDiffusion(60, 0.0);
+    const auto b = randomVector(A.rows(), 2);
+    const auto plain = nya::conjugateGradient(nya::execution::par, A, b);
+    const auto jacobi = nya::conjugateGradient(A, b, nya::JacobiPreconditioner<double> { A });
+    const auto ilu = nya::conjugateGradient(A, b, nya::ILU0Preconditioner<double> { A });
+    for (const auto* result : { &plain, &jacobi, &ilu }) {
+        EXPECT_TRUE(result->converged);
+        EXPECT_LT(result->iterations, 300);
+        EXPECT_LT(residualNorm(A, result->solution, b), 1e-9 * std::sqrt(double(b.size())));
+    }
+    EXPECT_LT(ilu.iterations, plain.iterations);
+
+    // deterministic regardless of policy
+    EXPECT_EQ(plain.solution, nya::conjugateGradient(A, b).solution);
+}
+
+TEST(SparseTest, Gmres) {
+    const auto A = convectionDiffusion(50, 200.0);
+    const auto b = randomVector(A.rows(), 3);
+    nya::IterativeOptions<double> options;
+    options.restart = 20;
+    options.maxIterations = 2000;
+    const auto plain = nya::gmres(nya::execution::par, A, b, nya::IdentityPreconditioner {}, options);
+    const auto ilu = nya::gmres(nya::execution::par, A, b, nya::ILU0Preconditioner<double> { A }, options);
+    for (const auto* result : { &plain, &ilu }) {
+        EXPECT_TRUE(result->converged);
+        EXPECT_NEAR(residualNorm(A, result->solution, b), result->residual, 1e-12);
+        EXPECT_LT(result->residual, 1e-10 * std::sqrt(double(b.size())));
+    }
+    EXPECT_LT(ilu.iterations * 3, plain.iterations);
+}
+
+TEST(SparseTest, Monitor) {
+    const auto A = convectionDiffusion(40, 0.0);
+    const auto b = randomVector(A.rows(), 4);
+    std::vector<double> history;
+    nya::IterativeOptions<double> options;
+    options.monitor = [&history](size_t iteration, double residual) {
+        history.push_back(residual);
+        EXPECT_EQ(iteration, history.size());
+        return iteration < 5;
+    };
+    const auto cg = nya::conjugateGradient(A, b, nya::JacobiPreconditioner<double> { A }, options);
+    EXPECT_FALSE(cg.converged);
+    EXPECT_EQ(cg.iterations, 5);
+    EXPECT_EQ(history.size(), 5);
+    EXPECT_EQ(history.back(), cg.residual);
+
+    history.clear();
+    const auto gm = nya::gmres(A, b, nya::IdentityPreconditioner {}, options);
+    EXPECT_FALSE(gm.converged);
+    EXPECT_EQ(gm.iterations, 5);
+    EXPECT_LT(history.back(), history.front());
+    EXPECT_NEAR(gm.residual, history.back(), 1e-12);
+
+    // monitor also sees the iteration that converges
+    options.monitor = [&history](size_t iteration, double residual) {
+        history.push_back(residual);
+        EXPECT_EQ(iteration, history.size());
+        return true;
+    };
+    history.clear();
+    const auto cgConverged = nya::conjugateGradient(A, b, nya::JacobiPreconditioner<double> { A }, options);
+    EXPECT_TRUE(cgConverged.converged);
+    EXPECT_EQ(history.size(), cgConverged.iterations);
+    EXPECT_EQ(history.back(), cgConverged.residual);
+    history.clear();
+    const auto gmConverged = nya::gmres(A, b, nya::IdentityPreconditioner {}, options);
+    EXPECT_TRUE(gmConverged.converged);
+    EXPECT_EQ(history.size(), gmConverged.iterations);
+
+    EXPECT_THROW(nya::gmres(A, std::vector<double>(3)), std::invalid_argument);
+}
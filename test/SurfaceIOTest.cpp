@@ -0,0 +1,138 @@
+#include "TestUtils.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <NumericalUtils.hpp>
+
+namespace {
+
+std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("numutils_" + name + ".surf")).string();
+}
+
+}
+
+TEST(SurfaceIOTest, RoundTrip) {
+    const auto path = tempPath("round_trip");
+    auto A = nya::AlignedSurface<double>::padded(7, 5, -1.0);
+    for (size_t i = 0; i < A.sizeX(); ++i) {
+        for (size_t j = 0; j < A.sizeY(); ++j) {
+            A.at(i, j) = 10.0 * i + j;
+        }
+    }
+    nya::writeSurface(path, A);
+    EXPECT_EQ(std::filesystem::file_size(path), sizeof(nya::SurfaceFileHeader) + 7 * 5 * sizeof(double));
+
+    const nya::MappedSurface<double> mapped (path);
+    EXPECT_EQ(mapped.sizeX(), 7);
+    EXPECT_EQ(mapped.sizeY(), 5);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(mapped.data()) % alignof(double), 0);
+    const auto view = mapped.view();
+    EXPECT_EQ(view(6, 4), 64.0);
+    EXPECT_EQ(view.column(2)(3, 0), 32.0);
+
+    const auto B = nya::readSurface<double>(path);
+    EXPECT_EQ(B.leadingDimension(), 5);
+    for (size_t i = 0; i < A.sizeX(); ++i) {
+        for (size_t j = 0; j < A.sizeY(); ++j) {
+            EXPECT_EQ(B.at(i, j), A.at(i, j));
+        }
+    }
+
+    nya::Surface<float, false> C (3, 4);
+    for (size_t i = 0; i < C.sizeX(); ++i) {
+        for (size_t j = 0; j < C.sizeY(); ++j) {
+            C.at(i, j) = float(i) - 0.5f * float(j);
+        }
+    }
+    nya::writeSurface(path, C);
+    const auto D = nya::readSurface<float, false>(path);
+    EXPECT_EQ(D, C);
+    std::filesystem::remove(path);
+}
+
+TEST(SurfaceIOTest, Streaming) {
+    const auto path = tempPath("streaming");
+    constexpr size_t rows = 1000, columns = 33, chunkRows = 64;
+    {
+        nya::SurfaceWriter<int64_t> writer (path, rows, columns);
+        nya::Surface<int64_t> chunk (chunkRows, columns);
+        for (size_t first = 0; first < rows; first += chunkRows) {
+            const size_t count = std::min(chunkRows, rows - first);
+            for (size_t i = 0; i < count; ++i) {
+                for (size_t j = 0; j < columns; ++j) {
+                    chunk.at(i, j) = int64_t((first + i) * columns + j);
+                }
+            }
+            writer.write(chunk.block(0, 0, count, columns));
+        }
+        EXPECT_EQ(writer.written(), rows * columns);
+        writer.close();
+    }
+    nya::MappedSurface<int64_t> mapped (path);
+    bool ok = true;
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < columns; ++j) {
+            ok &= mapped.at(i, j) == int64_t(i * columns + j);
+        }
+    }
+    EXPECT_TRUE(ok);
+
+    // moved mapping stays valid
+    auto moved = std::move(mapped);
+    EXPECT_EQ(moved.at(999, 32), int64_t(rows * columns - 1));
+    std::filesystem::remove(path);
+}
+
+TEST(SurfaceIOTest, Errors) {
+    const auto path = tempPath("errors");
+    nya::Surface<double> A (4, 4, 1.0);
+    nya::writeSurface(path, A);
+    EXPECT_THROW(nya::MappedSurface<float>{ path }, std::runtime_error);
+    EXPECT_THROW((nya::MappedSurface<double, false>{ path }), std::runtime_error);
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - sizeof(double));
+    EXPECT_THROW(nya::MappedSurface<double>{ path }, std::runtime_error);
+
+    {
+        std::ofstream out (path, std::ios::binary | std::ios::trunc);
+        out << "not a surface file, but long enough to hold a header of sixty four bytes ...";
+    }
+    EXPECT_THROW(nya::MappedSurface<double>{ path }, std::runtime_error);
+    EXPECT_THROW(nya::MappedSurface<double>{ tempPath("missing") }, std::runtime_error);
+
+    // sizes, whose element count overflows uint64_t, are rejected instead of wrapping around to a small count
+    nya::writeSurface(path, nya::Surface<double>(1, 1, 1.0));
+    nya::SurfaceFileHeader header;
+    {
+        std::ifstream in (path, std::ios::binary);
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    }
+    header.xSize = (uint64_t(1) << 32) + 1;
+    header.leadingDimension = uint64_t(1) << 32;
+    {
+        std::fstream out (path, std::ios::binary | std::ios::in | std::ios::out);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    EXPECT_THROW(nya::MappedSurface<double>{ path }, std::runtime_error);
+    header.xSize = 1;
+    header.ySize = uint64_t(1) << 62;
+    header.leadingDimension = header.ySize;
+    {
+        std::fstream out (path, std::ios::binary | std::ios::in | std::ios::out);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    EXPECT_THROW(nya::MappedSurface<double>{ path }, std::runtime_error);
+
+    nya::SurfaceWriter<double> writer (path, 2, 2);
+    const double values[] = { 1.0, 2.0, 3.0 };
+    writer.write(values, 3);
+    EXPECT_THROW(writer.write(values, 2), std::runtime_error);
+    EXPECT_THROW(writer.close(), std::runtime_error);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,128 @@
+#include "TestUtils.hpp"
+
+#include <cstdint>
+
+#include <NumericalUtils.hpp>
+
+TEST(SurfaceTest, Padded) {
+    auto A = nya::AlignedSurface<double>::padded(5, 13);
+    EXPECT_EQ(A.leadingDimension(), 16);
+    EXPECT_EQ(A.size(), 5 * 16);
+    auto B = nya::Surface<float, false>::padded(5, 13, 1.0f);
+    EXPECT_EQ(B.leadingDimension(), 16);
+    EXPECT_EQ(B.sizeX(), 5);
+    EXPECT_EQ(B.columnCount(), 5);
+
+    for (size_t i = 0; i < A.sizeX(); ++i) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(&A.at(i, 0)) % nya::cacheLineSize, 0);
+        for (size_t j = 0; j < A.sizeY(); ++j) {
+            A.at(i, j) = 100.0 * i + j;
+        }
+    }
+    EXPECT_EQ(A[2 * 16 + 3], 203.0);
+
+    // copies keep layout
+    const auto copy = A;
+    EXPECT_EQ(copy.leadingDimension(), 16);
+    EXPECT_EQ(copy.at(4, 12), 412.0);
+    nya::Surface<double> plain (2, 2);
+    plain = nya::Surface<double>::padded(3, 3, 7.0);
+    EXPECT_EQ(plain.leadingDimension(), 8);
+    EXPECT_EQ(plain.at(2, 2), 7.0);
+
+    // padding is not compared
+    auto padded = nya::Surface<double>::padded(3, 3, -1.0);
+    nya::Surface<double> dense (3, 3, 7.0);
+    EXPECT_NE(padded, dense);
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            padded.at(i, j) = 7.0;
+        }
+    }
+    EXPECT_EQ(padded, plain);
+    EXPECT_EQ(padded, dense);
+}
+
+TEST(SurfaceTest, Views) {
+    nya::Surface<double, false> A (4, 6);
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 6; ++j) {
+            A.at(i, j) = 10.0 * i + j;
+        }
+    }
+    // lines are in terms of x and y, while rowCount() / columnCount() follow storage order
+    EXPECT_EQ(A.rowCount(), 6);
+    const auto xLine = A.xLine(3);
+    ASSERT_EQ(xLine.columns, 6);
+    EXPECT_EQ(xLine(0, 5), 35.0);
+    const auto yLine = std::as_const(A).yLine(5);
+    ASSERT_EQ(yLine.rows, 4);
+    EXPECT_EQ(yLine(1, 0), 15.0);
+
+    // views refer to the same memory
+    auto block = A.block(1, 2, 2, 3);
+    block(1, 2) = -1.0;
+    EXPECT_EQ(A.at(2, 4), -1.0);
+    const auto transposed = block.transposed();
+    EXPECT_EQ(transposed.rows, 3);
+    EXPECT_EQ(transposed(2, 1), -1.0);
+    EXPECT_EQ(transposed.row(0)(0, 1), 22.0);
+}
+
+TEST(SurfaceTest, Arena) {
+    nya::Arena arena { 1024 };
+    {
+        nya::ArenaScope scope { arena };
+        double* a = scope.allocate<double>(10);
+        double* b = scope.allocate<double>(10);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % nya::cacheLineSize, 0);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % nya::cacheLineSize, 0);
+        EXPECT_GE(b - a, 10);
+        // larger than block
+        EXPECT_NE(scope.allocate<double>(1000), nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(arena.allocate(8, 256)) % 256, 0);
+    }
+    const size_t capacity = arena.capacity();
+    const auto start = arena.mark();
+
+    // memory is reused after the scope, no new blocks are needed for the same pattern
+    for (int i = 0; i < 10; ++i) {
+        nya::ArenaScope scope { arena };
+        scope.allocate<double>(10);
+        scope.allocate<double>(10);
+        scope.allocate<double>(1000);
+
+        nya::Surface<double, true, nya::ArenaAllocator<double>> A (10, 10, 1.0, nya::ArenaAllocator<double> { arena });
+        EXPECT_EQ(A.at(9, 9), 1.0);
+    }
+    EXPECT_EQ(arena.capacity(), capacity);
+    EXPECT_EQ(arena.mark().block, start.block);
+    EXPECT_EQ(arena.mark().offset, start.offset);
+}
+
+TEST(SurfaceTest, LinearAlgebra_Padded) {
+    // padded and column-major storage give the same results as plain one
+    const size_t n = 37;
+    nya::Surface<double> A (n, n);
+    auto padded = nya::AlignedSurface<double>::padded(n, n);
+    auto columnMajor = nya::Surface<double, false>::padded(n, n);
+    std::vector<double> b (n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            A.at(i, j) = padded.at(i, j) = columnMajor.at(i, j) = 1.0 / (i + j + 1) + (i == j ? 1.0 : 0.0);
+        }
+        b[i] = std::sin(i);
+    }
+    const auto x = nya::solveLinearSystem(A, b);
+    const auto xPadded = nya::solveLinearSystem(padded, b);
+    const auto xColumnMajor = nya::solveLinearSystem(columnMajor, b);
+    const auto AA = nya::multiply(nya::execution::par, A, A);
+    const auto AAPadded = nya::multiply(nya::execution::par, padded, columnMajor);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(xPadded[i], x[i], 1e-12);
+        EXPECT_NEAR(xColumnMajor[i], x[i], 1e-12);
+        for (size_t j = 0; j < n; ++j) {
+            EXPECT_NEAR(AAPadded.at(i, j), AA.at(i, j), 1e-12);
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#include "TestUtils.hpp"
+
+#include <ThreadPool.hpp>
+
+TEST(ThreadPoolTest, Submit) {
+    nya::ThreadPool pool { 2 };
+    EXPECT_EQ(pool.size(), 2);
+
+    auto result = pool.submit([] { return 42; });
+    EXPECT_EQ(result.get(), 42);
+}
+
+TEST(ThreadPoolTest, ParallelFor_VisitsEveryIndexOnce) {
+    std::vector<int> visited (1000);
+    nya::parallelFor(visited.size(), [&visited](size_t i) { ++visited[i]; });
+    EXPECT_TRUE(std::all_of(visited.begin(), visited.end(), [](int v) { return v == 1; }));
+}
+
+TEST(ThreadPoolTest, ParallelFor_Nested) {
+    nya::ThreadPool pool { 2 };
+    std::atomic<size_t> total { 0 };
+    nya::parallelFor(8, [&](size_t) {
+        nya::parallelFor(100, [&](size_t) { ++total; }, pool);
+    }, pool);
+    EXPECT_EQ(total, 800);
+}
+
+TEST(ThreadPoolTest, ParallelFor_RethrowsException) {
+    EXPECT_THROW(nya::parallelFor(100, [](size_t i) {
+        if (i == 50) {
+            throw std::runtime_error("test");
+        }
+    }), std::runtime_error);
+}